@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+
+namespace transport_catalogue::bench {
+
+    // Запускает fn iterations раз и возвращает среднее время одного запуска в миллисекундах
+    template <typename Fn>
+    double MeasureMs(Fn&& fn, int iterations = 5) {
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            fn();
+        }
+        const std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+        return elapsed.count() / iterations;
+    }
+
+    inline void Report(const char* name, double ms, double bytes = 0.0) {
+        if (bytes > 0.0) {
+            std::printf("%-40s %10.3f ms  %8.1f MB/s\n", name, ms, bytes / (1024.0 * 1024.0) / (ms / 1000.0));
+        } else {
+            std::printf("%-40s %10.3f ms\n", name, ms);
+        }
+    }
+
+    inline std::string StopName(int i) {
+        return "Stop " + std::to_string(i);
+    }
+
+    // Генерирует входной JSON справочника: stop_count остановок на сетке,
+    // маршруты с road_distances, render_settings и stat_requests (из них map_count запросов Map)
+    inline std::string MakeCatalogueJson(int stop_count, int stat_count = 0, unsigned seed = 42, int map_count = 0) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> lat(55.5, 56.0);
+        std::uniform_real_distribution<double> lng(37.3, 37.9);
+        std::uniform_int_distribution<int> dist(100, 5000);
+        std::uniform_int_distribution<int> pick(0, stop_count - 1);
+
+        std::string out = "{\n  \"base_requests\": [\n";
+        for (int i = 0; i < stop_count; ++i) {
+            out += "    {\"type\": \"Stop\", \"name\": \"" + StopName(i) + "\", \"latitude\": " + std::to_string(lat(rng))
+                   + ", \"longitude\": " + std::to_string(lng(rng)) + ", \"road_distances\": {";
+            for (int k = 1; k <= 3; ++k) {
+                out += (k > 1 ? ", \"" : "\"") + StopName((i + k) % stop_count) + "\": " + std::to_string(dist(rng));
+            }
+            out += "}},\n";
+        }
+        const int bus_count = stop_count / 10 + 1;
+        for (int b = 0; b < bus_count; ++b) {
+            out += "    {\"type\": \"Bus\", \"name\": \"" + std::to_string(b) + "\", \"stops\": [";
+            const int first = pick(rng);
+            for (int k = 0; k < 10; ++k) {
+                out += (k > 0 ? ", \"" : "\"") + StopName((first + k) % stop_count) + "\"";
+            }
+            out += "], \"is_roundtrip\": false}";
+            out += (b + 1 < bus_count) ? ",\n" : "\n";
+        }
+        out += "  ],\n"
+               "  \"render_settings\": {\"width\": 1200, \"height\": 1200, \"padding\": 50, \"line_width\": 14,"
+               " \"stop_radius\": 5, \"bus_label_font_size\": 20, \"bus_label_offset\": [7, 15],"
+               " \"stop_label_font_size\": 18, \"stop_label_offset\": [7, -3],"
+               " \"underlayer_color\": [255, 255, 255, 0.85], \"underlayer_width\": 3,"
+               " \"color_palette\": [\"green\", [255, 160, 0], \"red\"]},\n"
+               "  \"stat_requests\": [\n";
+        for (int i = 0; i < stat_count; ++i) {
+            if (i < map_count) {
+                out += "    {\"id\": " + std::to_string(i) + ", \"type\": \"Map\"}";
+            } else if (i % 2 == 0) {
+                out += "    {\"id\": " + std::to_string(i) + ", \"type\": \"Bus\", \"name\": \""
+                       + std::to_string(i % bus_count) + "\"}";
+            } else {
+                out += "    {\"id\": " + std::to_string(i) + ", \"type\": \"Stop\", \"name\": \""
+                       + StopName(pick(rng)) + "\"}";
+            }
+            out += (i + 1 < stat_count) ? ",\n" : "\n";
+        }
+        out += "  ]\n}\n";
+        return out;
+    }
+
+} // namespace transport_catalogue::bench
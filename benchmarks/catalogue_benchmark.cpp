@@ -0,0 +1,36 @@
+#include "bench_common.h"
+#include "json_reader.h"
+#include "map_renderer.h"
+#include "transport_catalogue.h"
+
+#include <cstdlib>
+
+using namespace transport_catalogue;
+
+int main(int argc, char** argv) {
+    const int stop_count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const std::string input = bench::MakeCatalogueJson(stop_count);
+
+    TransportCatalogue catalogue;
+    JsonReader reader(std::string_view(input), catalogue);
+    reader.ProcessBaseRequests();
+    std::printf("%zu stops, %zu buses\n", catalogue.GetStopCount(), catalogue.GetBusCount());
+
+    // Все запросы Bus подряд
+    double total = 0.0;
+    const double info_ms = bench::MeasureMs([&] {
+        for (const auto& bus : catalogue.GetAllBuses()) {
+            total += catalogue.GetBusInfo(bus.name)->route_length;
+        }
+    });
+    bench::Report("GetBusInfo, all buses", info_ms);
+
+    renderer::MapRenderer renderer;
+    reader.ProcessRenderSettings(renderer);
+    const double render_ms = bench::MeasureMs([&] {
+        const svg::Document doc = renderer.Render(catalogue);
+    }, 1);
+    bench::Report("MapRenderer::Render", render_ms);
+
+    std::printf("checksum %.1f\n", total);
+}
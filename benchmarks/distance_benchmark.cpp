@@ -0,0 +1,80 @@
+#include "bench_common.h"
+#include "json_reader.h"
+#include "transport_catalogue.h"
+
+#include <cstdlib>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace transport_catalogue;
+
+namespace {
+
+    // Прежнее хранилище расстояний — для сравнения
+    struct PtrPairHasher {
+        size_t operator()(const std::pair<const void*, const void*>& p) const {
+            size_t h1 = std::hash<const void*>{}(p.first);
+            size_t h2 = std::hash<const void*>{}(p.second);
+            return h1 + 37 * h2;
+        }
+    };
+
+    using PtrPairMap = std::unordered_map<std::pair<const Stop*, const Stop*>, double, PtrPairHasher>;
+
+    double MapDistance(const PtrPairMap& distances, const Stop* from, const Stop* to) {
+        auto it = distances.find({from, to});
+        if (it != distances.end()) {
+            return it->second;
+        }
+        it = distances.find({to, from});
+        return it != distances.end() ? it->second : 0.0;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int stop_count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const std::string input = bench::MakeCatalogueJson(stop_count);
+
+    TransportCatalogue catalogue;
+    JsonReader reader(std::string_view(input), catalogue);
+    reader.ProcessBaseRequests();
+
+    // Пары соседних остановок всех маршрутов в обоих направлениях: как в GetBusInfo
+    std::vector<std::pair<const Stop*, const Stop*>> pairs;
+    for (const auto& bus : catalogue.GetAllBuses()) {
+        for (size_t i = 1; i < bus.stops.size(); ++i) {
+            pairs.emplace_back(bus.stops[i - 1], bus.stops[i]);
+            pairs.emplace_back(bus.stops[i], bus.stops[i - 1]);
+        }
+    }
+
+    // Генератор задаёт расстояния от каждой остановки до трёх следующих
+    PtrPairMap map;
+    for (const auto& from : catalogue.GetAllStops()) {
+        for (int k = 1; k <= 3; ++k) {
+            const Stop& to = catalogue.GetStop((from.id + k) % catalogue.GetStopCount());
+            map[{&from, &to}] = catalogue.GetDistance(&from, &to);
+        }
+    }
+    std::printf("%zu stops, %zu lookups\n", catalogue.GetStopCount(), pairs.size());
+
+    double map_sum = 0.0;
+    const double map_ms = bench::MeasureMs([&] {
+        for (const auto& [from, to] : pairs) {
+            map_sum += MapDistance(map, from, to);
+        }
+    });
+    bench::Report("unordered_map + PtrPairHasher", map_ms);
+
+    double csr_sum = 0.0;
+    const double csr_ms = bench::MeasureMs([&] {
+        for (const auto& [from, to] : pairs) {
+            csr_sum += catalogue.GetDistance(from, to);
+        }
+    });
+    bench::Report("CSR distance store", csr_ms);
+
+    std::printf("checksums %.1f %.1f\n", map_sum, csr_sum);
+}
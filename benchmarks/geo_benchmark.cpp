@@ -0,0 +1,57 @@
+#include "bench_common.h"
+#include "geo.h"
+#include "json_reader.h"
+#include "transport_catalogue.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace transport_catalogue;
+
+int main(int argc, char** argv) {
+    const int stop_count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const std::string input = bench::MakeCatalogueJson(stop_count);
+
+    TransportCatalogue catalogue;
+    JsonReader reader(std::string_view(input), catalogue);
+    reader.ProcessBaseRequests();
+
+    // Все перегоны всех маршрутов подряд
+    std::vector<uint32_t> from;
+    std::vector<uint32_t> to;
+    for (BusId bus = 0; bus < catalogue.GetBusCount(); ++bus) {
+        const auto route = catalogue.GetRoute(bus);
+        for (size_t i = 1; i < route.size(); ++i) {
+            from.push_back(route[i - 1]);
+            to.push_back(route[i]);
+        }
+    }
+    const auto coordinates = catalogue.GetStopCoordinates();
+    std::printf("%zu stops, %zu segments\n", coordinates.size(), from.size());
+
+    std::vector<double> scalar(from.size());
+    const double scalar_ms = bench::MeasureMs([&] {
+        for (size_t i = 0; i < from.size(); ++i) {
+            scalar[i] = geo::ComputeDistance(coordinates[from[i]], coordinates[to[i]]);
+        }
+    });
+    bench::Report("geo::ComputeDistance", scalar_ms);
+
+    geo::PointTable points;
+    const double table_ms = bench::MeasureMs([&] { points = geo::PointTable(coordinates); }, 1);
+    bench::Report("geo::PointTable build", table_ms);
+
+    std::vector<double> batch(from.size());
+    const double batch_ms = bench::MeasureMs([&] { geo::ComputeDistances(points, from, to, batch); });
+    bench::Report("geo::ComputeDistances", batch_ms);
+
+    double max_relative = 0.0;
+    for (size_t i = 0; i < from.size(); ++i) {
+        if (scalar[i] > 0.0) {
+            max_relative = std::max(max_relative, std::abs(batch[i] - scalar[i]) / scalar[i]);
+        }
+    }
+    std::printf("max relative difference %.3g\n", max_relative);
+}
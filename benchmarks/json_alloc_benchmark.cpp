@@ -0,0 +1,79 @@
+#include "bench_common.h"
+#include "json.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <optional>
+
+// Подсчёт обращений к глобальному распределителю памяти
+namespace {
+    std::atomic<size_t> g_allocations{0};
+    std::atomic<size_t> g_deallocations{0};
+}
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    if (p) {
+        ++g_deallocations;
+    }
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+// std::pmr::new_delete_resource выделяет память через выровненные версии
+void* operator new(std::size_t size, std::align_val_t align) {
+    ++g_allocations;
+    const auto alignment = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    operator delete(p);
+}
+
+using namespace transport_catalogue;
+
+namespace {
+
+    void Measure(const char* name, const std::string& input, const json::LoadOptions& options) {
+        const size_t alloc_before = g_allocations;
+        const size_t dealloc_before = g_deallocations;
+        double load_ms = 0.0;
+        double destroy_ms = 0.0;
+        {
+            std::optional<json::Document> doc;
+            load_ms = bench::MeasureMs([&] { doc.emplace(json::Load(input, options)); }, 1);
+            destroy_ms = bench::MeasureMs([&] { doc.reset(); }, 1);
+        }
+        std::printf("%-28s allocations %9zu  frees %9zu  load %8.2f ms  destroy %7.2f ms\n", name,
+                    g_allocations - alloc_before, g_deallocations - dealloc_before, load_ms, destroy_ms);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int stop_count = argc > 1 ? std::atoi(argv[1]) : 50000;
+    const std::string input = bench::MakeCatalogueJson(stop_count, stop_count);
+    std::printf("input: %d stops, %.1f MB\n", stop_count, static_cast<double>(input.size()) / (1024.0 * 1024.0));
+
+    Measure("global allocator", input, {});
+    Measure("document arena", input, {json::ScanMode::Scalar, true});
+}
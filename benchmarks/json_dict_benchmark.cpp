@@ -0,0 +1,63 @@
+#include "bench_common.h"
+#include "json.h"
+
+#include <cstdlib>
+#include <map>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals;
+using namespace transport_catalogue;
+
+namespace {
+
+    // Прежнее представление словаря — для сравнения
+    using TreeDict = std::map<std::string, json::Node, std::less<>>;
+
+    constexpr std::string_view kKeys[] = {"type"sv, "name"sv, "latitude"sv, "longitude"sv, "road_distances"sv, "id"sv};
+
+    template <typename DictT>
+    std::vector<DictT> Build(int count) {
+        std::vector<DictT> dicts;
+        dicts.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            DictT d;
+            // Объекты запросов содержат 3–6 ключей
+            const int keys = 3 + i % 4;
+            for (int k = 0; k < keys; ++k) {
+                d.emplace(std::string(kKeys[k]), json::Node(i + k));
+            }
+            dicts.push_back(std::move(d));
+        }
+        return dicts;
+    }
+
+    template <typename DictT>
+    long long Lookup(const std::vector<DictT>& dicts) {
+        long long sum = 0;
+        for (const auto& d : dicts) {
+            for (std::string_view key : kKeys) {
+                if (auto it = d.find(key); it != d.end()) {
+                    sum += it->second.AsInt();
+                }
+            }
+        }
+        return sum;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 200000;
+    std::printf("%d dicts with 3-6 keys\n", count);
+
+    bench::Report("build std::map<std::string, Node>", bench::MeasureMs([&] { Build<TreeDict>(count); }));
+    bench::Report("build json::Dict", bench::MeasureMs([&] { Build<json::Dict>(count); }));
+
+    const auto tree = Build<TreeDict>(count);
+    const auto flat = Build<json::Dict>(count);
+    long long sink = 0;
+    bench::Report("lookup std::map (string_view)", bench::MeasureMs([&] { sink += Lookup(tree); }));
+    bench::Report("lookup json::Dict (string_view)", bench::MeasureMs([&] { sink += Lookup(flat); }));
+    std::printf("checksum %lld\n", sink);
+}
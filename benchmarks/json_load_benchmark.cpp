@@ -0,0 +1,47 @@
+#include "bench_common.h"
+#include "json.h"
+
+#include <cstdlib>
+#include <sstream>
+
+using namespace transport_catalogue;
+
+int main(int argc, char** argv) {
+    const int stop_count = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const std::string input = bench::MakeCatalogueJson(stop_count, stop_count);
+    const double bytes = static_cast<double>(input.size());
+    std::printf("input: %d stops, %.1f MB\n", stop_count, bytes / (1024.0 * 1024.0));
+
+    const double stream_ms = bench::MeasureMs([&] {
+        std::istringstream in(input);
+        json::Document doc = json::Load(in);
+    });
+    bench::Report("json::Load(std::istream&)", stream_ms, bytes);
+
+    const double buffer_ms = bench::MeasureMs([&] {
+        json::Document doc = json::Load(std::string_view(input));
+    });
+    bench::Report("json::Load(std::string_view)", buffer_ms, bytes);
+
+    const double indexed_ms = bench::MeasureMs([&] {
+        json::Document doc = json::Load(input, {json::ScanMode::Structural});
+    });
+    bench::Report("json::Load(ScanMode::Structural)", indexed_ms, bytes);
+
+    // Документ из длинных названий остановок и числовых массивов
+    std::string strings = "[";
+    for (int i = 0; i < stop_count; ++i) {
+        strings += "\"" + std::string(40 + i % 80, static_cast<char>('a' + i % 26)) + " " + bench::StopName(i)
+                   + "\", [" + std::to_string(i * 0.5) + ", " + std::to_string(i) + "],\n";
+    }
+    strings += "null]";
+    const double strings_bytes = static_cast<double>(strings.size());
+    std::printf("long strings: %.1f MB\n", strings_bytes / (1024.0 * 1024.0));
+
+    bench::Report("long strings, ScanMode::Scalar", bench::MeasureMs([&] {
+        json::Document doc = json::Load(strings, {json::ScanMode::Scalar});
+    }), strings_bytes);
+    bench::Report("long strings, ScanMode::Structural", bench::MeasureMs([&] {
+        json::Document doc = json::Load(strings, {json::ScanMode::Structural});
+    }), strings_bytes);
+}
@@ -0,0 +1,42 @@
+#include "bench_common.h"
+#include "json.h"
+
+#include <cstdlib>
+#include <sstream>
+
+using namespace transport_catalogue;
+
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 500000;
+
+    // Координаты, расстояния и целые идентификаторы вперемешку
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-180.0, 180.0);
+    std::uniform_int_distribution<int> distance(0, 100000);
+    std::string input = "[";
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) {
+            input += ", ";
+        }
+        char buf[32];
+        const int len = i % 3 == 2 ? std::snprintf(buf, sizeof(buf), "%d", distance(rng))
+                                   : std::snprintf(buf, sizeof(buf), "%.17g", coord(rng));
+        input.append(buf, len);
+    }
+    input += "]";
+    const double bytes = static_cast<double>(input.size());
+    std::printf("%d numbers, %.1f MB\n", count, bytes / (1024.0 * 1024.0));
+
+    bench::Report("json::Load numbers", bench::MeasureMs([&] {
+        json::Document doc = json::Load(std::string_view(input));
+    }), bytes);
+
+    const json::Document doc = json::Load(std::string_view(input));
+    size_t printed = 0;
+    const double print_ms = bench::MeasureMs([&] {
+        std::ostringstream out;
+        json::Print(doc, out);
+        printed = out.str().size();
+    });
+    bench::Report("json::Print numbers", print_ms, static_cast<double>(printed));
+}
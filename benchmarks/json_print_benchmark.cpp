@@ -0,0 +1,69 @@
+#include "bench_common.h"
+#include "json.h"
+#include "json_reader.h"
+#include "map_renderer.h"
+#include "request_handler.h"
+
+#include <cstdlib>
+#include <fstream>
+
+using namespace transport_catalogue;
+
+int main(int argc, char** argv) {
+    const int stop_count = argc > 1 ? std::atoi(argv[1]) : 5000;
+    const int map_count = argc > 2 ? std::atoi(argv[2]) : 10;
+    const std::string input = bench::MakeCatalogueJson(stop_count, map_count, 42, map_count);
+
+    TransportCatalogue catalogue;
+    JsonReader reader(std::string_view(input), catalogue);
+    reader.ProcessBaseRequests();
+    renderer::MapRenderer renderer;
+    reader.ProcessRenderSettings(renderer);
+    RequestHandler handler(catalogue, renderer);
+
+    const json::Document responses{json::Node{reader.ProcessStatRequests(handler)}};
+    std::printf("%d stops, %d Map responses\n", stop_count, map_count);
+
+    std::ofstream sink("/dev/null");
+    for (const bool compact : {false, true}) {
+        const json::PrintOptions options{compact};
+        size_t bytes = 0;
+        const double ms = bench::MeasureMs([&] {
+            json::Writer writer(sink, options);
+            writer.WriteNode(responses.GetRoot());
+            writer.Flush();
+            bytes = writer.BytesWritten();
+        });
+        std::printf("%s: %zu bytes\n", compact ? "compact" : "pretty", bytes);
+        bench::Report(compact ? "json::Print compact" : "json::Print pretty", ms, static_cast<double>(bytes));
+    }
+
+    // Пакет запросов Map целиком: SVG текст карты готовится один раз, а в каждый ответ
+    // он выводится из кэша сразу с экранированием, без промежуточных копий
+    const double map_batch_ms = bench::MeasureMs([&] {
+        json::Writer writer(sink);
+        reader.ProcessStatRequests(handler, writer);
+    });
+    bench::Report("Map batch streamed", map_batch_ms);
+
+    // Ответы Bus и Stop: через дерево Node и Print против прямой записи TextBuilder
+    const int stat_count = argc > 3 ? std::atoi(argv[3]) : 20000;
+    const std::string stat_input = bench::MakeCatalogueJson(stop_count, stat_count);
+    TransportCatalogue stat_catalogue;
+    JsonReader stat_reader(std::string_view(stat_input), stat_catalogue);
+    stat_reader.ProcessBaseRequests();
+    RequestHandler stat_handler(stat_catalogue, renderer);
+    std::printf("%d Bus/Stop responses\n", stat_count);
+
+    const double tree_ms = bench::MeasureMs([&] {
+        json::Writer writer(sink);
+        writer.WriteNode(json::Node{stat_reader.ProcessStatRequests(stat_handler)});
+        writer.Flush();
+    });
+    bench::Report("stat responses via Node tree", tree_ms);
+    const double text_ms = bench::MeasureMs([&] {
+        json::Writer writer(sink);
+        stat_reader.ProcessStatRequests(stat_handler, writer);
+    });
+    bench::Report("stat responses via TextBuilder", text_ms);
+}
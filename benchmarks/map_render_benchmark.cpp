@@ -0,0 +1,107 @@
+#include "bench_common.h"
+#include "json_reader.h"
+#include "map_renderer.h"
+#include "thread_pool.h"
+#include "transport_catalogue.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace transport_catalogue;
+
+// Счётчики выделений памяти, чтобы видеть, сколько занимает построенный документ.
+// Размер блока хранится перед ним, чтобы учитывать и освобождения
+namespace {
+    constexpr size_t HEADER = alignof(std::max_align_t);
+    size_t allocation_count = 0;
+    size_t live_bytes = 0;
+}
+
+void* operator new(size_t size) {
+    ++allocation_count;
+    live_bytes += size;
+    if (auto* p = static_cast<char*>(std::malloc(size + HEADER))) {
+        *reinterpret_cast<size_t*>(p) = size;
+        return p + HEADER;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    if (p) {
+        char* block = static_cast<char*>(p) - HEADER;
+        live_bytes -= *reinterpret_cast<size_t*>(block);
+        std::free(block);
+    }
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+int main(int argc, char** argv) {
+    const int stop_count = argc > 1 ? std::atoi(argv[1]) : 50000;
+    const size_t max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+                                        : std::max(1u, std::thread::hardware_concurrency());
+    const std::string input = bench::MakeCatalogueJson(stop_count);
+
+    TransportCatalogue catalogue;
+    JsonReader reader(std::string_view(input), catalogue);
+    reader.ProcessBaseRequests();
+    renderer::MapRenderer renderer;
+    reader.ProcessRenderSettings(renderer);
+    std::printf("%d stops, %zu buses\n", stop_count, catalogue.GetBusCount());
+
+    // Построение документа и его вывод измеряются отдельно
+    const double build_ms = bench::MeasureMs([&] { (void)renderer.Render(catalogue); });
+    bench::Report("svg::Document build", build_ms);
+
+    const size_t count_before = allocation_count;
+    const size_t bytes_before = live_bytes;
+    const svg::Document doc = renderer.Render(catalogue);
+    std::printf("svg::Document: %zu allocations while building, %.1f MB kept\n", allocation_count - count_before,
+                static_cast<double>(live_bytes - bytes_before) / (1024.0 * 1024.0));
+    std::ostringstream text;
+    doc.Render(text);
+    const double bytes = static_cast<double>(text.str().size());
+
+    const double string_ms = bench::MeasureMs([&] {
+        std::ostringstream out;
+        doc.Render(out);
+    });
+    bench::Report("svg::Document render to string", string_ms, bytes);
+
+    std::ofstream sink("/dev/null");
+    const double file_ms = bench::MeasureMs([&] { doc.Render(sink); });
+    bench::Report("svg::Document render to file", file_ms, bytes);
+
+    // Карта целиком, как для запроса Map: слои по частям строятся и выводятся на пуле потоков.
+    // Каждый раз новый рендерер, чтобы карта не бралась из кэша
+    auto run = [&](ThreadPool* pool) {
+        std::string svg;
+        const double ms = bench::MeasureMs([&] {
+            renderer::MapRenderer fresh;
+            reader.ProcessRenderSettings(fresh);
+            fresh.SetThreadPool(pool);
+            std::ostringstream out;
+            fresh.RenderSvg(catalogue, out);
+            svg = std::move(out).str();
+        });
+        return std::make_pair(ms, svg);
+    };
+    const auto [serial_ms, serial_svg] = run(nullptr);
+    bench::Report("map build + SVG, serial", serial_ms, static_cast<double>(serial_svg.size()));
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        ThreadPool pool(threads);
+        const auto [ms, svg] = run(&pool);
+        std::printf("%2zu threads: %10.3f ms, speedup %.2fx%s\n", threads, ms, serial_ms / ms,
+                    svg == serial_svg && svg == text.str() ? "" : " (output differs!)");
+    }
+}
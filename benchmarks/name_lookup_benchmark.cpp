@@ -0,0 +1,59 @@
+#include "bench_common.h"
+#include "perfect_hash.h"
+
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace transport_catalogue;
+
+int main(int argc, char** argv) {
+    const int stop_count = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    std::vector<std::string> names;
+    std::vector<std::string> missing;
+    names.reserve(stop_count);
+    for (int i = 0; i < stop_count; ++i) {
+        names.push_back(bench::StopName(i));
+        missing.push_back(bench::StopName(i + stop_count));
+    }
+
+    // Прежний индекс каталога — для сравнения
+    std::unordered_map<std::string_view, uint32_t> map;
+    std::vector<std::pair<std::string_view, uint32_t>> items;
+    for (uint32_t i = 0; i < names.size(); ++i) {
+        map[names[i]] = i;
+        items.emplace_back(names[i], i);
+    }
+
+    PerfectHashIndex index;
+    const double build_ms = bench::MeasureMs([&] { index = PerfectHashIndex(items); }, 1);
+    bench::Report("PerfectHashIndex build", build_ms);
+
+    const size_t map_bytes = map.bucket_count() * sizeof(void*)
+                             + map.size() * (sizeof(std::pair<std::string_view, uint32_t>) + 2 * sizeof(void*));
+    std::printf("memory: unordered_map ~%zu KiB, perfect hash %zu KiB\n", map_bytes / 1024, index.MemoryUsage() / 1024);
+
+    for (const bool hit : {true, false}) {
+        const auto& keys = hit ? names : missing;
+        size_t found = 0;
+        const double map_ms = bench::MeasureMs([&] {
+            for (const auto& key : keys) {
+                found += map.count(key);
+            }
+        });
+        bench::Report(hit ? "unordered_map, hits" : "unordered_map, misses", map_ms);
+
+        const double mph_ms = bench::MeasureMs([&] {
+            for (const auto& key : keys) {
+                // Как в TransportCatalogue::FindStop: кандидата подтверждает сравнение имени
+                const uint32_t id = index.Find(key);
+                found += id != INVALID_ID && names[id] == key;
+            }
+        });
+        bench::Report(hit ? "perfect hash, hits" : "perfect hash, misses", mph_ms);
+        std::printf("found %zu\n", found);
+    }
+}
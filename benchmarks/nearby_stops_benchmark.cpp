@@ -0,0 +1,58 @@
+#include "bench_common.h"
+#include "transport_catalogue.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace transport_catalogue;
+
+int main(int argc, char** argv) {
+    const int stop_count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int query_count = 1000;
+
+    // Остановки в пределах одного большого города
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> lat(55.5, 56.0);
+    std::uniform_real_distribution<double> lng(37.3, 37.9);
+
+    // Без Freeze() каталог отвечает перебором всех остановок — это и есть линейный поиск
+    TransportCatalogue scanned;
+    TransportCatalogue indexed;
+    for (int i = 0; i < stop_count; ++i) {
+        const geo::Coordinates point{lat(rng), lng(rng)};
+        scanned.AddStop(bench::StopName(i), point);
+        indexed.AddStop(bench::StopName(i), point);
+    }
+    const double build_ms = bench::MeasureMs([&] { indexed.Freeze(); }, 1);
+    bench::Report("Freeze (with KD-tree build)", build_ms);
+
+    std::vector<geo::Coordinates> centers;
+    for (int i = 0; i < query_count; ++i) {
+        centers.push_back({lat(rng), lng(rng)});
+    }
+
+    const double no_radius = std::numeric_limits<double>::infinity();
+    const size_t no_limit = std::numeric_limits<size_t>::max();
+    struct Query {
+        const char* name;
+        double radius;
+        size_t limit;
+    };
+    for (const auto& [name, radius, limit] : {Query{"radius 500 m", 500.0, no_limit},
+                                              Query{"10 nearest", no_radius, 10},
+                                              Query{"10 nearest within 2 km", 2000.0, 10}}) {
+        for (const TransportCatalogue* db : {&scanned, &indexed}) {
+            size_t found = 0;
+            const double ms = bench::MeasureMs([&] {
+                for (const auto& center : centers) {
+                    found += db->FindNearbyStops(center, radius, limit).size();
+                }
+            });
+            std::printf("%s, %s: %.2f us/query, %zu found\n", db == &indexed ? "KD-tree" : "linear scan", name,
+                        ms * 1000.0 / query_count, found);
+        }
+    }
+}
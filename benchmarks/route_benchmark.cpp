@@ -0,0 +1,84 @@
+#include "bench_common.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace transport_catalogue;
+
+namespace {
+
+    // Сетка side x side остановок в 400 м друг от друга; по каждой строке и каждому столбцу
+    // ходит некольцевой автобус
+    void FillGrid(TransportCatalogue& db, int side) {
+        for (int r = 0; r < side; ++r) {
+            for (int c = 0; c < side; ++c) {
+                db.AddStop(bench::StopName(r * side + c), {55.5 + r * 0.0036, 37.3 + c * 0.0063});
+            }
+        }
+        auto stop = [&db, side](int r, int c) { return &db.GetStop(static_cast<StopId>(r * side + c)); };
+        for (int r = 0; r < side; ++r) {
+            for (int c = 0; c + 1 < side; ++c) {
+                db.SetDistance(stop(r, c), stop(r, c + 1), 400);
+                db.SetDistance(stop(c, r), stop(c + 1, r), 400);
+            }
+        }
+        for (int line = 0; line < side; ++line) {
+            std::vector<const Stop*> row;
+            std::vector<const Stop*> column;
+            for (int k = 0; k < side; ++k) {
+                row.push_back(stop(line, k));
+                column.push_back(stop(k, line));
+            }
+            db.AddBus("R" + std::to_string(line), row, false);
+            db.AddBus("C" + std::to_string(line), column, false);
+        }
+        db.Freeze();
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int query_count = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+    for (const int stop_count : {10000, 30000, 100000}) {
+        const int side = static_cast<int>(std::sqrt(stop_count));
+        TransportCatalogue db;
+        FillGrid(db, side);
+
+        std::optional<router::TransportRouter> router;
+        const double build_ms = bench::MeasureMs([&] { router.emplace(db, router::RoutingSettings{6.0, 40.0}); }, 1);
+        std::printf("%d stops, %zu vertices, %zu edges\n", side * side, router->GetGraph().GetVertexCount(),
+                    router->GetGraph().GetEdgeCount());
+        bench::Report("graph build", build_ms);
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<StopId> pick(0, static_cast<StopId>(db.GetStopCount() - 1));
+        std::vector<std::pair<const Stop*, const Stop*>> queries;
+        for (int i = 0; i < query_count; ++i) {
+            queries.emplace_back(&db.GetStop(pick(rng)), &db.GetStop(pick(rng)));
+        }
+
+        auto run_queries = [&](const char* name) {
+            double total_time = 0.0;
+            const double ms = bench::MeasureMs([&] {
+                for (const auto& [from, to] : queries) {
+                    total_time += router->BuildRoute(from, to)->total_time;
+                }
+            }, 1);
+            std::printf("%s: %.1f us/query (checksum %.3f)\n", name, ms * 1000.0 / query_count, total_time);
+        };
+        run_queries("Dijkstra");
+
+        const double index_ms = bench::MeasureMs([&] { router->BuildIndex(); }, 1);
+        bench::Report("landmark index build", index_ms);
+        std::printf("index: %zu landmarks, %zu distances\n", router->GetIndex()->GetLandmarks().size(),
+                    router->GetIndex()->GetDistances().size());
+        run_queries("A* with landmarks");
+    }
+}
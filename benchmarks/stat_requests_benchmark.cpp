@@ -0,0 +1,50 @@
+#include "bench_common.h"
+#include "json_reader.h"
+#include "map_renderer.h"
+#include "request_handler.h"
+#include "thread_pool.h"
+#include "transport_catalogue.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace transport_catalogue;
+
+int main(int argc, char** argv) {
+    const int stat_count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const size_t max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+                                        : std::max(1u, std::thread::hardware_concurrency());
+
+    // Смесь запросов Bus и Stop к справочнику из 10000 остановок
+    const std::string input = bench::MakeCatalogueJson(10000, stat_count);
+    TransportCatalogue db;
+    JsonReader reader(std::string_view(input), db);
+    reader.ProcessBaseRequests();
+    renderer::MapRenderer renderer;
+    reader.ProcessRenderSettings(renderer);
+    const RequestHandler handler(db, renderer);
+
+    auto run = [&](ThreadPool* pool) {
+        std::ostringstream out;
+        const double ms = bench::MeasureMs([&] {
+            out.str({});
+            json::Writer writer(out);
+            reader.ProcessStatRequests(handler, writer, pool);
+        }, 3);
+        return std::make_pair(ms, out.str());
+    };
+
+    const auto [serial_ms, serial_output] = run(nullptr);
+    std::printf("%d requests\n", stat_count);
+    bench::Report("serial", serial_ms);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        ThreadPool pool(threads);
+        const auto [ms, output] = run(&pool);
+        std::printf("%2zu threads: %10.3f ms, speedup %.2fx%s\n", threads, ms, serial_ms / ms,
+                    output == serial_output ? "" : " (output differs!)");
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -7,15 +9,28 @@
 
 namespace transport_catalogue {
 
+    // Dense identifiers: a stop or bus ID is its index in the catalogue's arrays
+    using StopId = uint32_t;
+    using BusId = uint32_t;
+
+    inline constexpr uint32_t INVALID_ID = std::numeric_limits<uint32_t>::max();
+
     struct Stop {
         std::string name;
         geo::Coordinates coordinates;
+        StopId id = INVALID_ID;
     };
 
     struct Bus {
         std::string name;
         std::vector<const Stop*> stops;
         bool is_roundtrip = false;
+        BusId id = INVALID_ID;
+    };
+
+    struct StopDistance {
+        const Stop* stop = nullptr;
+        double distance = 0.0;
     };
 
     struct BusInfo {
@@ -25,4 +40,4 @@ namespace transport_catalogue {
         double curvature = 0.0;
     };
 
-}  // namespace transport_catalogue
\ No newline at end of file
+}  // namespace transport_catalogue
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+    using VertexId = uint32_t;
+    using EdgeId = uint32_t;
+
+    template <typename Weight>
+    struct Edge {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+    };
+
+    // Outgoing edge as stored for traversal: everything a search needs in one place
+    template <typename Weight>
+    struct IncidentEdge {
+        VertexId to;
+        EdgeId id;
+        Weight weight;
+    };
+
+    // Directed graph with weighted edges, built once from a list of edges.
+    // EdgeId is the position of an edge in that list. Outgoing edges of vertex v are
+    // GetIncidentEdges(v); they are copied back to back for all vertices (compressed
+    // sparse row), so a search reads them sequentially without going through edge IDs
+    template <typename Weight>
+    class DirectedWeightedGraph {
+    public:
+        DirectedWeightedGraph() = default;
+        DirectedWeightedGraph(size_t vertex_count, std::vector<Edge<Weight>> edges);
+
+        [[nodiscard]] size_t GetVertexCount() const { return incidence_offsets_.size() - 1; }
+        [[nodiscard]] size_t GetEdgeCount() const { return edges_.size(); }
+        [[nodiscard]] const Edge<Weight>& GetEdge(EdgeId id) const { return edges_[id]; }
+        [[nodiscard]] const std::vector<Edge<Weight>>& GetEdges() const { return edges_; }
+
+        [[nodiscard]] std::span<const IncidentEdge<Weight>> GetIncidentEdges(VertexId vertex) const {
+            const auto first = incidence_.begin() + incidence_offsets_[vertex];
+            return {first, first + (incidence_offsets_[vertex + 1] - incidence_offsets_[vertex])};
+        }
+
+    private:
+        std::vector<Edge<Weight>> edges_;
+        std::vector<uint32_t> incidence_offsets_{0};
+        std::vector<IncidentEdge<Weight>> incidence_;
+    };
+
+    template <typename Weight>
+    DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count, std::vector<Edge<Weight>> edges)
+            : edges_(std::move(edges)), incidence_offsets_(vertex_count + 1, 0), incidence_(edges_.size()) {
+        // Counting sort of edge IDs by source vertex keeps the edges of a vertex in insertion order
+        for (const auto& edge : edges_) {
+            if (edge.from >= vertex_count || edge.to >= vertex_count) {
+                throw std::out_of_range("DirectedWeightedGraph: edge refers to a missing vertex");
+            }
+            ++incidence_offsets_[edge.from + 1];
+        }
+        for (size_t v = 0; v < vertex_count; ++v) {
+            incidence_offsets_[v + 1] += incidence_offsets_[v];
+        }
+        std::vector<uint32_t> next(incidence_offsets_.begin(), incidence_offsets_.end() - 1);
+        for (EdgeId id = 0; id < edges_.size(); ++id) {
+            const auto& edge = edges_[id];
+            incidence_[next[edge.from]++] = {edge.to, id, edge.weight};
+        }
+    }
+
+} // namespace graph
@@ -1,16 +1,68 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
 namespace json {
 
     class Node;
-    using Dict = std::map<std::string, Node>;
-    using Array = std::vector<Node>;
+    // Контейнеры берут память из std::pmr::memory_resource: по умолчанию это обычная куча,
+    // а у документа, загруженного с ареной, — его собственная монотонная арена
+    using Array = std::pmr::vector<Node>;
+
+    // Словарь JSON: пары ключ-значение в непрерывном массиве, упорядоченном по ключу.
+    // Повторяет нужную часть интерфейса std::map (find, emplace, обход по возрастанию ключей),
+    // но не выделяет память под каждый ключ отдельно и ищет по std::string_view без создания строки.
+    // Рассчитан на небольшие объекты запросов: вставка в середину стоит O(n)
+    class Dict {
+    public:
+        using key_type = std::string;
+        using mapped_type = Node;
+        using value_type = std::pair<std::string, Node>;
+        using Storage = std::pmr::vector<value_type>;
+        using iterator = Storage::iterator;
+        using const_iterator = Storage::const_iterator;
+
+        Dict() = default;
+        explicit Dict(std::pmr::memory_resource* resource);
+        Dict(std::initializer_list<value_type> items);
+
+        [[nodiscard]] iterator find(std::string_view key);
+        [[nodiscard]] const_iterator find(std::string_view key) const;
+        [[nodiscard]] size_t count(std::string_view key) const;
+        [[nodiscard]] bool contains(std::string_view key) const;
+
+        // Возвращает значение по ключу, при его отсутствии выбрасывает std::out_of_range
+        [[nodiscard]] const Node& at(std::string_view key) const;
+
+        // Как и std::map::emplace, не заменяет значение уже существующего ключа
+        std::pair<iterator, bool> emplace(std::string key, Node value);
+
+        [[nodiscard]] iterator begin() noexcept { return items_.begin(); }
+        [[nodiscard]] iterator end() noexcept { return items_.end(); }
+        [[nodiscard]] const_iterator begin() const noexcept { return items_.begin(); }
+        [[nodiscard]] const_iterator end() const noexcept { return items_.end(); }
+
+        [[nodiscard]] size_t size() const noexcept { return items_.size(); }
+        [[nodiscard]] bool empty() const noexcept { return items_.empty(); }
+
+        bool operator==(const Dict& rhs) const;
+        bool operator!=(const Dict& rhs) const { return !(*this == rhs); }
+
+    private:
+        [[nodiscard]] const_iterator LowerBound(std::string_view key) const;
+
+        Storage items_;
+    };
 
     class ParsingError : public std::runtime_error {
     public:
@@ -137,17 +189,108 @@ namespace json {
         return !(lhs == rhs);
     }
 
+    // ---------- Dict ----------
+    // Определения вынесены сюда: им нужен полный тип Node
+
+    inline Dict::Dict(std::pmr::memory_resource* resource)
+            : items_(resource) {
+    }
+
+    inline Dict::Dict(std::initializer_list<value_type> items) {
+        for (const auto& [key, value] : items) {
+            emplace(key, value);
+        }
+    }
+
+    inline Dict::const_iterator Dict::LowerBound(std::string_view key) const {
+        return std::lower_bound(items_.begin(), items_.end(), key, [](const value_type& item, std::string_view k) {
+            return std::string_view(item.first) < k;
+        });
+    }
+
+    inline Dict::const_iterator Dict::find(std::string_view key) const {
+        const auto it = LowerBound(key);
+        return it != items_.end() && it->first == key ? it : items_.end();
+    }
+
+    inline Dict::iterator Dict::find(std::string_view key) {
+        return items_.begin() + (std::as_const(*this).find(key) - items_.cbegin());
+    }
+
+    inline size_t Dict::count(std::string_view key) const {
+        return find(key) != end() ? 1 : 0;
+    }
+
+    inline bool Dict::contains(std::string_view key) const {
+        return find(key) != end();
+    }
+
+    inline const Node& Dict::at(std::string_view key) const {
+        using namespace std::literals;
+        const auto it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("No key '"s + std::string(key) + "' in dict"s);
+        }
+        return it->second;
+    }
+
+    inline std::pair<Dict::iterator, bool> Dict::emplace(std::string key, Node value) {
+        // Ключи во входных данных часто идут по возрастанию — тогда вставка идёт в конец
+        if (items_.empty() || items_.back().first < key) {
+            items_.emplace_back(std::move(key), std::move(value));
+            return {items_.end() - 1, true};
+        }
+        const auto pos = items_.begin() + (LowerBound(key) - items_.cbegin());
+        if (pos->first == key) {
+            return {pos, false};
+        }
+        return {items_.emplace(pos, std::move(key), std::move(value)), true};
+    }
+
+    inline bool Dict::operator==(const Dict& rhs) const {
+        return items_ == rhs.items_;
+    }
+
     class Document {
     public:
         explicit Document(Node root)
                 : root_(std::move(root)) {
         }
 
+        // Документ, контейнеры которого размещены в арене arena.
+        // Арена освобождается целиком вместе с документом
+        Document(Node root, std::shared_ptr<std::pmr::memory_resource> arena)
+                : arena_(std::move(arena))
+                , root_(std::move(root)) {
+        }
+
+        // Копия не ссылается на арену: её контейнеры размещаются в обычной куче
+        Document(const Document& other)
+                : root_(other.root_) {
+        }
+
+        Document& operator=(const Document& other) {
+            if (this != &other) {
+                root_ = other.root_;
+                arena_.reset();
+            }
+            return *this;
+        }
+
+        Document(Document&&) noexcept = default;
+        Document& operator=(Document&&) noexcept = default;
+
         const Node& GetRoot() const {
             return root_;
         }
 
+        [[nodiscard]] bool HasArena() const noexcept {
+            return arena_ != nullptr;
+        }
+
     private:
+        // Объявлена раньше root_, чтобы пережить узлы при разрушении
+        std::shared_ptr<std::pmr::memory_resource> arena_;
         Node root_;
     };
 
@@ -161,6 +304,170 @@ namespace json {
 
     Document Load(std::istream& input);
 
-    void Print(const Document& doc, std::ostream& output);
+    // Способ просмотра буфера при разборе
+    enum class ScanMode {
+        // Посимвольный просмотр
+        Scalar,
+        // Сначала векторный проход (AVX2/SSE4.2, при их отсутствии скалярный) строит индекс
+        // кавычек, слэшей и структурных символов, и содержимое строк пропускается по нему.
+        // Скобки, запятые и двоеточия между значениями читаются как при Scalar.
+        // Выгоден на документах с длинными строками
+        Structural,
+    };
+
+    struct LoadOptions {
+        ScanMode scan_mode = ScanMode::Scalar;
+        // Разместить все массивы и словари документа в монотонной арене, которой владеет
+        // Document: миллионы мелких выделений заменяются несколькими крупными блоками,
+        // а при разрушении память не возвращается в кучу по одному узлу
+        bool use_arena = false;
+    };
+
+    // Разбирает документ из непрерывного буфера (строка, отображённый в память файл).
+    // Результат и ошибки совпадают с Load(std::istream&) при любых опциях, но разбор заметно быстрее
+    Document Load(std::string_view input, const LoadOptions& options = {});
+
+    // Получатель событий потокового разбора (SAX).
+    // Строки, переданные в Key и String, действительны только на время вызова
+    class EventHandler {
+    public:
+        virtual ~EventHandler() = default;
+
+        virtual void StartObject() = 0;
+        virtual void Key(std::string_view key) = 0;
+        virtual void EndObject() = 0;
+        virtual void StartArray() = 0;
+        virtual void EndArray() = 0;
+        virtual void String(std::string_view value) = 0;
+        virtual void Int(int value) = 0;
+        virtual void Double(double value) = 0;
+        virtual void Bool(bool value) = 0;
+        virtual void Null() = 0;
+    };
+
+    // Разбирает документ из буфера, не строя дерево Node: о каждом элементе
+    // сообщается обработчику. Грамматика и ошибки совпадают с Load
+    void Parse(std::string_view input, EventHandler& handler, ScanMode mode = ScanMode::Scalar);
+
+    // Обработчик событий, собирающий из них Node. Позволяет построить дерево
+    // только для нужной части документа
+    class NodeBuilder final : public EventHandler {
+    public:
+        void StartObject() override;
+        void Key(std::string_view key) override;
+        void EndObject() override;
+        void StartArray() override;
+        void EndArray() override;
+        void String(std::string_view value) override;
+        void Int(int value) override;
+        void Double(double value) override;
+        void Bool(bool value) override;
+        void Null() override;
+
+        // Значение полностью собрано и может быть извлечено
+        [[nodiscard]] bool HasValue() const noexcept {
+            return has_root_;
+        }
+
+        Node Extract();
+
+    private:
+        void Complete();
+        void Place(Node&& value);
+
+        Node root_;
+        bool has_root_ = false;
+        std::vector<Node> stack_;
+        std::vector<std::string> keys_;
+    };
+
+    struct PrintOptions {
+        // Без переводов строк и отступов
+        bool compact = false;
+        // Шаг отступа в пробелах для форматированного вывода
+        int indent_step = 4;
+    };
+
+    // Строковое значение, которое не хранится целиком: write выводит текст в поток по частям,
+    // а Writer экранирует их и передаёт дальше по мере поступления
+    struct StreamedString {
+        std::function<void(std::ostream&)> write;
+    };
+
+    // Буферизованный вывод JSON-текста. Копит текст во внутреннем буфере и передаёт
+    // его в поток крупными блоками. Значения выводятся последовательно, как при обходе
+    // дерева: Start*/End* открывают и закрывают контейнеры, Key задаёт ключ словаря.
+    // Остаток буфера сбрасывается в поток при вызове Flush и в деструкторе
+    class Writer {
+    public:
+        explicit Writer(std::ostream& out, PrintOptions options = {});
+        // Писатель элементов массива, открытого в parent: значения оформляются как его
+        // элементы с тем же отступом. Так части одного массива можно готовить отдельно,
+        // например в разных потоках, а потом добавить в parent через AppendElements
+        Writer(std::ostream& out, const Writer& parent);
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+        ~Writer();
+
+        void StartArray();
+        void EndArray();
+        void StartDict();
+        void EndDict();
+        void Key(std::string_view key);
+
+        void Value(std::string_view value);
+        void Value(const char* value);
+        void Value(const std::string& value);
+        void Value(int value);
+        void Value(double value);
+        void Value(bool value);
+        void Value(std::nullptr_t);
+        void Value(const StreamedString& value);
+
+        // Выводит узел со всеми вложенными значениями
+        void WriteNode(const Node& node);
+
+        // Добавляет в открытый массив элементы, выведенные писателем, созданным от этого
+        void AppendElements(std::string_view text);
+
+        void Flush();
+
+        // Сколько байт уже передано в поток
+        [[nodiscard]] size_t BytesWritten() const noexcept {
+            return bytes_written_;
+        }
+
+    private:
+        static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+        struct Frame {
+            bool is_dict;
+            bool first;
+        };
+
+        class EscapingBuffer;
+
+        void Write(std::string_view text);
+        void Put(char c);
+        void WriteIndent(size_t depth);
+        // Строка в кавычках
+        void WriteEscaped(std::string_view text);
+        // Содержимое строки без кавычек
+        void WriteEscapedChars(std::string_view text);
+        template <typename Number>
+        void WriteNumber(Number value);
+
+        void BeforeValue();
+        void OpenContainer(char bracket, bool is_dict);
+        void CloseContainer(char bracket);
+
+        std::ostream& out_;
+        PrintOptions options_;
+        std::string buffer_;
+        std::vector<Frame> frames_;
+        size_t bytes_written_ = 0;
+    };
+
+    void Print(const Document& doc, std::ostream& output, const PrintOptions& options = {});
 
 }  // namespace json
\ No newline at end of file
@@ -2,10 +2,13 @@
 
 #include "json.h"
 
+#include <cstdint>
 #include <optional>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace json {
@@ -93,3 +96,132 @@ namespace json {
     };
 
 } // namespace json
+
+namespace json {
+
+    // Построитель с тем же интерфейсом контекстов, что и Builder, но без промежуточного
+    // дерева Node: значения сразу выводятся текстом через Writer. Сам построитель
+    // не выделяет память, поэтому подходит для частых небольших ответов
+    class TextBuilder {
+    private:
+        class BaseContext;
+        class DictContext;
+        class KeyContext;
+        class ArrayContext;
+
+    public:
+        explicit TextBuilder(Writer& writer) : writer_(writer) {}
+
+        TextBuilder::DictContext StartDict();
+        TextBuilder::ArrayContext StartArray();
+        template <typename T>
+        TextBuilder::BaseContext Value(const T& value);
+        TextBuilder::KeyContext Key(std::string_view key);
+
+        // Проверяет, что значение полностью выведено
+        void Build() const;
+
+    private:
+        // Глубина вложенности ограничена числом битов в маске контейнеров
+        static constexpr int MAX_DEPTH = 64;
+
+        void EnsureNotReady(const char* where) const;
+        void EnsureCanPlaceValue(const char* where) const;
+        void EnsureInDictForKey(const char* where) const;
+        void PushContainer(bool is_dict);
+        void PopContainer(bool is_dict, const char* where);
+
+        template <typename T>
+        void PlaceValue(const T& value) {
+            EnsureNotReady("Value()");
+            EnsureCanPlaceValue("Value()");
+            if constexpr (std::is_same_v<T, Node>) {
+                writer_.WriteNode(value);
+            } else {
+                writer_.Value(value);
+            }
+            has_root_ = true;
+            pending_key_ = false;
+        }
+
+        [[nodiscard]] bool InDict() const noexcept {
+            return depth_ > 0 && (dict_mask_ >> (depth_ - 1) & 1u) != 0;
+        }
+
+        [[nodiscard]] bool Ready() const noexcept {
+            return has_root_ && depth_ == 0;
+        }
+
+        Writer& writer_;
+        uint64_t dict_mask_ = 0;
+        int depth_ = 0;
+        bool has_root_ = false;
+        bool pending_key_ = false;
+
+    private:
+        class BaseContext {
+        public:
+            explicit BaseContext(TextBuilder& builder) : b_(builder) {}
+
+            void Build() { b_.Build(); }
+
+            KeyContext Key(std::string_view key);
+            template <typename T>
+            BaseContext& Value(const T& value) {
+                b_.PlaceValue(value);
+                return *this;
+            }
+            DictContext  StartDict();
+            ArrayContext StartArray();
+            BaseContext EndDict();
+            BaseContext  EndArray();
+
+        protected:
+            TextBuilder& b_;
+        };
+
+        class DictContext : private BaseContext {
+        public:
+            explicit DictContext(TextBuilder& b) : BaseContext(b) {}
+
+            using BaseContext::EndDict;
+            using BaseContext::Key;
+        };
+
+        class KeyContext : private BaseContext {
+        public:
+            explicit KeyContext(TextBuilder& b) : BaseContext(b) {}
+
+            template <typename T>
+            DictContext Value(const T& v) {
+                b_.PlaceValue(v);
+                return DictContext(b_);
+            }
+
+            DictContext StartDict()  { return BaseContext::StartDict(); }
+            ArrayContext StartArray() { return BaseContext::StartArray(); }
+        };
+
+        class ArrayContext : private BaseContext {
+        public:
+            explicit ArrayContext(TextBuilder& b) : BaseContext(b) {}
+
+            template <typename T>
+            ArrayContext Value(const T& v) {
+                b_.PlaceValue(v);
+                return ArrayContext(b_);
+            }
+
+            using BaseContext::StartDict;
+            using BaseContext::StartArray;
+            using BaseContext::EndArray;
+        };
+    };
+
+    template <typename T>
+    TextBuilder::BaseContext TextBuilder::Value(const T& value) {
+        PlaceValue(value);
+        return BaseContext(*this);
+    }
+
+} // namespace json
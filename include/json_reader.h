@@ -4,6 +4,14 @@
 #include "request_handler.h"
 #include "json.h"
 #include "map_renderer.h"
+#include "thread_pool.h"
+#include "transport_router.h"
+
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace transport_catalogue {
 
@@ -12,20 +20,45 @@ namespace transport_catalogue {
         explicit JsonReader(json::Document input_doc,
                             TransportCatalogue& db);
 
+        // Streaming mode: reads requests straight from parser events without
+        // building a tree for the whole document, one request at a time
+        explicit JsonReader(std::string_view input,
+                            TransportCatalogue& db,
+                            json::ScanMode scan_mode = json::ScanMode::Scalar);
+
         // Process base_requests into the catalogue
         void ProcessBaseRequests();
 
-        // Build JSON array with answers for stat_requests
-        [[nodiscard]] json::Array ProcessStatRequests(const RequestHandler& handler) const;
+        // Build JSON array with answers for stat_requests.
+        // With a pool the answers are computed on its threads
+        [[nodiscard]] json::Array ProcessStatRequests(const RequestHandler& handler,
+                                                      ThreadPool* pool = nullptr) const;
+
+        // Stream answers for stat_requests to writer as a JSON array: each answer is
+        // written as soon as it is computed and then dropped.
+        // With a pool the answers are computed on its threads a window at a time and
+        // written in the order of the requests; the text is the same as without one
+        void ProcessStatRequests(const RequestHandler& handler, json::Writer& writer,
+                                 ThreadPool* pool = nullptr) const;
 
         // Read render settings from the input document
         void ProcessRenderSettings(renderer::MapRenderer& renderer);
 
+        // Raw render_settings node of the input (null when there is none)
+        [[nodiscard]] const json::Node& GetRenderSettings() const { return render_settings_; }
+        void SetRenderSettings(json::Node settings) { render_settings_ = std::move(settings); }
+
+        // Settings of the routing_settings block, std::nullopt when the input has none
+        [[nodiscard]] std::optional<router::RoutingSettings> GetRoutingSettings() const;
+
     private:
+        class StreamHandler;
+
         TransportCatalogue& db_;
-        json::Document input_doc_;
+        json::Node render_settings_;
+        json::Node routing_settings_;
 
-        void ReadInput();
+        void ReadInput(const json::Node& root);
 
         struct StopInput {
             std::string name;
@@ -43,11 +76,27 @@ namespace transport_catalogue {
             std::string type;
             std::string name;
             int id = 0;
+            // Route: names of the first and the last stop
+            std::string from;
+            std::string to;
+            // NearbyStops: a search center and at least one of radius (meters) and count;
+            // the center is set only when both coordinates are given
+            std::optional<geo::Coordinates> center;
+            std::optional<double> radius;
+            std::optional<size_t> count;
         };
 
         void ParseBaseRequests(const json::Array& reqs);
         void ParseStatRequests(const json::Array& reqs);
 
+        void ParseBaseRequest(const json::Node& node);
+        void ParseStatRequest(const json::Node& node);
+
+        [[nodiscard]] json::Node ProcessStatRequest(const StatRequest& req, const RequestHandler& handler) const;
+
+        template <typename ResponseBuilder>
+        void BuildStatResponse(ResponseBuilder& builder, const StatRequest& req, const RequestHandler& handler) const;
+
         void ParseStopRequests(const json::Dict& dict);
         void ParseBusRequests(const json::Dict& dict);
 
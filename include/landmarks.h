@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "graph.h"
+#include "router.h"
+
+namespace graph {
+
+    // Precomputed lower bounds for A* search over a DirectedWeightedGraph<double> (ALT:
+    // A*, landmarks and the triangle inequality).
+    //
+    // For a few landmark vertices L the index keeps d(L, v) and d(v, L) for every vertex v.
+    // Then d(v, t) >= d(L, t) - d(L, v) and d(v, t) >= d(v, L) - d(t, L), and A* guided by
+    // the best of these bounds settles mostly the vertices lying towards the target instead
+    // of a whole ball around the source. The paths found are shortest, as from graph::Router.
+    //
+    // Landmarks are picked one by one, each as far as possible from those picked before, which
+    // puts them at the outskirts of the network. Preprocessing is two full Dijkstra runs per
+    // landmark, so it stays linear in the size of the graph
+    class Landmarks {
+    public:
+        static constexpr size_t DEFAULT_COUNT = 8;
+
+        Landmarks() = default;
+
+        // Preprocesses the graph; weights must be non-negative
+        explicit Landmarks(const DirectedWeightedGraph<double>& graph, size_t count = DEFAULT_COUNT);
+
+        // Restores an index from the parts of a previously built one (see snapshot.h).
+        // Throws std::invalid_argument when they are inconsistent
+        Landmarks(std::vector<VertexId> landmarks, std::vector<float> distances, uint64_t graph_hash);
+
+        // Shortest path in the graph the index was built for
+        [[nodiscard]] std::optional<Router<double>::RouteInfo> BuildRoute(const DirectedWeightedGraph<double>& graph,
+                                                                          VertexId from, VertexId to) const;
+
+        [[nodiscard]] size_t GetVertexCount() const {
+            return landmarks_.empty() ? 0 : distances_.size() / (2 * landmarks_.size());
+        }
+        [[nodiscard]] const std::vector<VertexId>& GetLandmarks() const { return landmarks_; }
+        // Per vertex: its distances from every landmark, then to every landmark;
+        // infinity where there is no path
+        [[nodiscard]] const std::vector<float>& GetDistances() const { return distances_; }
+        [[nodiscard]] uint64_t GetGraphHash() const { return graph_hash_; }
+
+        // Whether the index was built for exactly this graph
+        [[nodiscard]] bool Matches(const DirectedWeightedGraph<double>& graph) const;
+
+        // Fingerprint of the vertex count and the edges of a graph
+        [[nodiscard]] static uint64_t HashGraph(const DirectedWeightedGraph<double>& graph);
+
+    private:
+        struct Scratch;
+
+        // Largest error of the bounds due to keeping distances as float
+        void ComputeSlack();
+
+        // Lower bound on the distance from v to the target whose row of distances is given
+        [[nodiscard]] double LowerBound(VertexId v, const float* target) const;
+
+        std::vector<VertexId> landmarks_;
+        std::vector<float> distances_;
+        uint64_t graph_hash_ = 0;
+        double slack_ = 0.0;
+    };
+
+} // namespace graph
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <optional>
@@ -9,6 +14,7 @@
 #include "svg.h"
 #include "geo.h"
 #include "domain.h"
+#include "thread_pool.h"
 #include "transport_catalogue.h"
 
 namespace transport_catalogue::renderer {
@@ -85,14 +91,50 @@ namespace transport_catalogue::renderer {
 
     class MapRenderer {
     public:
+        // Buses or stops per part of a layer when the map is built for RenderSvgText()
+        static constexpr size_t CHUNK_SIZE = 1024;
+
         MapRenderer() = default;
 
-        void SetSettings(RenderSettings s) { settings_ = std::move(s); }
+        void SetSettings(RenderSettings s);
+
+        // Pool to build and format maps on; nullptr (the default) keeps all work in the
+        // calling thread. The output is the same either way
+        void SetThreadPool(ThreadPool* pool) { pool_ = pool; }
 
         [[nodiscard]] svg::Document Render(const transport_catalogue::TransportCatalogue& db) const;
 
+        // The map as SVG text, the same as Render(db) gives. The layers are cut into chunks of
+        // CHUNK_SIZE buses or stops, which are built and formatted in parallel and joined in order.
+        // It is done once per catalogue version and settings and the text is then shared by all
+        // callers until either changes; may be called from several threads at once
+        [[nodiscard]] std::shared_ptr<const std::string> RenderSvgText(
+                const transport_catalogue::TransportCatalogue& db) const;
+
+        // Writes the text of RenderSvgText() to out
+        void RenderSvg(const transport_catalogue::TransportCatalogue& db, std::ostream& out) const;
+
     private:
         RenderSettings settings_;
+        uint64_t settings_hash_ = 0;
+        ThreadPool* pool_ = nullptr;
+
+        // The last map RenderSvgText() produced and what it was rendered from
+        struct SvgCache {
+            std::mutex mutex;
+            uint64_t catalogue_version = 0;
+            uint64_t settings_hash = 0;
+            std::shared_ptr<const std::string> svg;
+        };
+        mutable SvgCache svg_cache_;
+
+        // What all layers are drawn from
+        struct Layout;
+
+        [[nodiscard]] Layout MakeLayout(const transport_catalogue::TransportCatalogue& db) const;
+        // The layers in their order, each cut into chunks of CHUNK_SIZE buses or stops
+        [[nodiscard]] std::vector<svg::Document> RenderParts(const transport_catalogue::TransportCatalogue& db) const;
+        void ForEach(size_t count, const std::function<void(size_t)>& body) const;
 
         [[nodiscard]] const svg::Color& ColorForIndex(size_t i) const;
         [[nodiscard]] svg::Text MakeBusTextUnderlayer(svg::Point p, std::string_view name) const;
@@ -101,23 +143,11 @@ namespace transport_catalogue::renderer {
         [[nodiscard]] svg::Text MakeStopText(svg::Point p, std::string_view name) const;
 
     private:
-        void RenderBusLines(svg::Document& doc,
-                            const std::vector<const Bus*>& buses,
-                            const detail::SphereProjector& proj,
-                            std::vector<size_t>& bus_color_index) const;
-
-        void RenderBusLabels(svg::Document& doc,
-                             const std::vector<const Bus*>& buses,
-                             const detail::SphereProjector& proj,
-                             const std::vector<size_t>& bus_color_index) const;
-
-        void RenderStopCircles(svg::Document& doc,
-                               const std::vector<const Stop*>& stops,
-                               const detail::SphereProjector& proj) const;
-
-        void RenderStopLabels(svg::Document& doc,
-                              const std::vector<const Stop*>& stops,
-                              const detail::SphereProjector& proj) const;
+        // Each layer draws the buses or stops with numbers in [first, last) of the sorted lists
+        void RenderBusLines(svg::Document& doc, const Layout& layout, size_t first, size_t last) const;
+        void RenderBusLabels(svg::Document& doc, const Layout& layout, size_t first, size_t last) const;
+        void RenderStopCircles(svg::Document& doc, const Layout& layout, size_t first, size_t last) const;
+        void RenderStopLabels(svg::Document& doc, const Layout& layout, size_t first, size_t last) const;
 
     };
 
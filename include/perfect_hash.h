@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "domain.h"
+
+namespace transport_catalogue {
+
+    // Minimal perfect hash over a fixed set of names (hash-and-displace).
+    // Keys are split into buckets; every bucket gets a seed chosen so that its keys land
+    // in free slots of a table with exactly one slot per key. A 16-bit fingerprint per slot
+    // rejects most unknown names without touching the name itself.
+    // The table does not store the names: Find() returns a candidate ID which the caller
+    // must confirm by comparing the name it refers to
+    class PerfectHashIndex {
+    public:
+        PerfectHashIndex() = default;
+
+        // Builds the table over (name, id) pairs. Names must be distinct
+        explicit PerfectHashIndex(const std::vector<std::pair<std::string_view, uint32_t>>& items);
+
+        // Restores a table from the arrays of a previously built one (see snapshot.h)
+        PerfectHashIndex(std::vector<uint32_t> seeds, std::vector<uint32_t> ids, std::vector<uint16_t> fingerprints);
+
+        // Returns the ID the name would have, or INVALID_ID if it is certainly absent
+        [[nodiscard]] uint32_t Find(std::string_view name) const;
+
+        [[nodiscard]] size_t Size() const { return ids_.size(); }
+        [[nodiscard]] bool Empty() const { return ids_.empty(); }
+
+        // Memory taken by the table
+        [[nodiscard]] size_t MemoryUsage() const;
+
+        [[nodiscard]] const std::vector<uint32_t>& GetSeeds() const { return seeds_; }
+        [[nodiscard]] const std::vector<uint32_t>& GetIds() const { return ids_; }
+        [[nodiscard]] const std::vector<uint16_t>& GetFingerprints() const { return fingerprints_; }
+
+    private:
+        [[nodiscard]] static uint64_t Hash(std::string_view name);
+        [[nodiscard]] static uint64_t Slot(uint64_t hash, uint32_t seed, size_t size);
+
+        [[nodiscard]] static uint16_t Fingerprint(uint64_t hash) {
+            return static_cast<uint16_t>(hash >> 48);
+        }
+
+        [[nodiscard]] size_t Bucket(uint64_t hash) const {
+            return static_cast<uint32_t>(hash) % seeds_.size();
+        }
+
+        std::vector<uint32_t> seeds_;
+        std::vector<uint32_t> ids_;
+        std::vector<uint16_t> fingerprints_;
+    };
+
+} // namespace transport_catalogue
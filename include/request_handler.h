@@ -1,29 +1,47 @@
 #pragma once
 
+#include <ostream>
 #include <string>
-#include <unordered_set>
+#include <optional>
+#include <span>
+#include <vector>
 
 #include "transport_catalogue.h"
 #include "map_renderer.h"
+#include "transport_router.h"
 
 namespace transport_catalogue {
 
     class RequestHandler {
     public:
-        RequestHandler(const TransportCatalogue& db, const renderer::MapRenderer& renderer);
+        // Без router запросы маршрутов остаются без ответа
+        RequestHandler(const TransportCatalogue& db, const renderer::MapRenderer& renderer,
+                       const router::TransportRouter* router = nullptr);
 
         // Возвращает информацию о маршруте (запрос Bus)
         [[nodiscard]] std::optional<BusInfo> GetBusInfo(const std::string_view& bus_name) const;
 
-        // Возвращает маршруты, проходящие через
-        [[nodiscard]] const std::unordered_set<const Bus*>* GetBusesByStop(const std::string_view& stop_name) const;
+        // Возвращает маршруты, проходящие через остановку, упорядоченные по названию
+        [[nodiscard]] std::optional<std::span<const Bus* const>> GetBusesByStop(const std::string_view& stop_name) const;
+
+        // Возвращает остановки не дальше radius метров от center, ближайшие первыми, не больше limit штук
+        [[nodiscard]] std::vector<StopDistance> GetNearbyStops(geo::Coordinates center, double radius,
+                                                               size_t limit) const;
+
+        // Возвращает самый быстрый маршрут между остановками (запрос Route)
+        [[nodiscard]] std::optional<router::RouteInfo> BuildRoute(std::string_view from, std::string_view to) const;
 
         // Рендерит карту и возвращает SVG документ
         [[nodiscard]] svg::Document RenderMap() const;
 
+        // Выводит карту в виде SVG текста. Пока справочник и настройки не меняются,
+        // текст всех запросов выводится из одного и того же отрендеренного документа
+        void RenderMapSvg(std::ostream& out) const;
+
     private:
         const TransportCatalogue& db_;
         const renderer::MapRenderer& renderer_;
+        const router::TransportRouter* router_;
     };
 
 }
\ No newline at end of file
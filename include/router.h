@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+
+namespace graph {
+
+    // Point-to-point shortest paths by Dijkstra's algorithm with a binary heap.
+    // The search stops as soon as the target is settled. Working arrays live in
+    // thread-local storage and are reset lazily by a generation stamp, so a query
+    // costs only what it visits, and concurrent queries from different threads are safe
+    template <typename Weight>
+    class Router {
+    public:
+        struct RouteInfo {
+            Weight weight;
+            std::vector<EdgeId> edges;
+        };
+
+        explicit Router(const DirectedWeightedGraph<Weight>& graph) : graph_(graph) {
+        }
+
+        [[nodiscard]] std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+
+    private:
+        static constexpr EdgeId NO_EDGE = static_cast<EdgeId>(-1);
+
+        struct Scratch {
+            std::vector<Weight> distance;
+            std::vector<EdgeId> prev_edge;
+            std::vector<uint32_t> stamp;
+            uint32_t generation = 0;
+            std::vector<std::pair<Weight, VertexId>> heap;
+        };
+
+        static Scratch& GetScratch(size_t vertex_count);
+
+        const DirectedWeightedGraph<Weight>& graph_;
+    };
+
+    template <typename Weight>
+    typename Router<Weight>::Scratch& Router<Weight>::GetScratch(size_t vertex_count) {
+        thread_local Scratch scratch;
+        if (scratch.stamp.size() < vertex_count) {
+            scratch.distance.resize(vertex_count);
+            scratch.prev_edge.resize(vertex_count);
+            scratch.stamp.resize(vertex_count, 0);
+        }
+        if (++scratch.generation == 0) {
+            std::fill(scratch.stamp.begin(), scratch.stamp.end(), 0);
+            scratch.generation = 1;
+        }
+        scratch.heap.clear();
+        return scratch;
+    }
+
+    template <typename Weight>
+    auto Router<Weight>::BuildRoute(VertexId from, VertexId to) const -> std::optional<RouteInfo> {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count) {
+            return std::nullopt;
+        }
+
+        Scratch& s = GetScratch(vertex_count);
+        const auto by_distance = std::greater<>{};
+        auto reached = [&s](VertexId v) { return s.stamp[v] == s.generation; };
+
+        s.stamp[from] = s.generation;
+        s.distance[from] = Weight{};
+        s.prev_edge[from] = NO_EDGE;
+        s.heap.emplace_back(Weight{}, from);
+        while (!s.heap.empty()) {
+            std::pop_heap(s.heap.begin(), s.heap.end(), by_distance);
+            const auto [distance, vertex] = s.heap.back();
+            s.heap.pop_back();
+            if (distance > s.distance[vertex]) {
+                continue;  // stale heap entry
+            }
+            if (vertex == to) {
+                break;
+            }
+            for (const auto& edge : graph_.GetIncidentEdges(vertex)) {
+                const Weight candidate = distance + edge.weight;
+                if (!reached(edge.to) || candidate < s.distance[edge.to]) {
+                    s.stamp[edge.to] = s.generation;
+                    s.distance[edge.to] = candidate;
+                    s.prev_edge[edge.to] = edge.id;
+                    s.heap.emplace_back(candidate, edge.to);
+                    std::push_heap(s.heap.begin(), s.heap.end(), by_distance);
+                }
+            }
+        }
+
+        if (!reached(to)) {
+            return std::nullopt;
+        }
+        RouteInfo route{s.distance[to], {}};
+        for (EdgeId id = s.prev_edge[to]; id != NO_EDGE; id = s.prev_edge[graph_.GetEdge(id).from]) {
+            route.edges.push_back(id);
+        }
+        std::reverse(route.edges.begin(), route.edges.end());
+        return route;
+    }
+
+} // namespace graph
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "json.h"
+#include "landmarks.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+// Binary snapshot of a frozen catalogue: everything ProcessBaseRequests() and Freeze()
+// build, laid out as flat arrays so that loading is a few bulk copies out of a mapped file.
+//
+// The file is a fixed header followed by 8-byte aligned sections (string table, stop names
+// and coordinates, bus records, route sequences, CSR distances, bus lists per stop,
+// precomputed BusInfo, perfect hash tables of names, KD-tree order of stops,
+// render settings as JSON text, and optionally routing settings with the landmark
+// index built for them).
+// Numbers are stored in the byte order of the machine that wrote the file;
+// a snapshot from a machine with another byte order is rejected.
+namespace transport_catalogue::snapshot {
+
+    inline constexpr uint32_t VERSION = 3;
+
+    class SnapshotError : public std::runtime_error {
+    public:
+        using runtime_error::runtime_error;
+    };
+
+    // Routing part of a snapshot: the settings a router was built with and its
+    // landmark index, if it had one
+    struct RouteIndex {
+        router::RoutingSettings settings;
+        std::optional<graph::Landmarks> landmarks;
+    };
+
+    // Writes the catalogue and render settings. The catalogue must be frozen.
+    // With a router, also writes its settings and landmark index
+    void SaveToFile(const TransportCatalogue& db, const json::Node& render_settings, const std::string& path,
+                    const router::TransportRouter* router = nullptr);
+    std::string Save(const TransportCatalogue& db, const json::Node& render_settings,
+                     const router::TransportRouter* router = nullptr);
+
+    // Fills an empty catalogue from a snapshot and returns the saved render settings.
+    // The catalogue comes out frozen. If route_index is given, it receives the routing
+    // part of the snapshot, or std::nullopt when it has none
+    json::Node LoadFromFile(const std::string& path, TransportCatalogue& db,
+                            std::optional<RouteIndex>* route_index = nullptr);
+    json::Node Load(std::string_view data, TransportCatalogue& db, std::optional<RouteIndex>* route_index = nullptr);
+
+    // Read-only view of a whole file: mapped into memory where the platform allows it
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] std::string_view GetData() const { return {data_, size_}; }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        std::string buffer_;  // file contents when it is not mapped
+    };
+
+} // namespace transport_catalogue::snapshot
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "domain.h"
+#include "geo.h"
+
+namespace transport_catalogue {
+
+    // KD-tree over stop positions. Points are unit vectors in 3D, where the straight-line
+    // distance orders points the same way as the distance along the Earth's surface,
+    // so the search is exact and has no trouble with the antimeridian or the poles.
+    // The tree is implicit: the node of a range [lo, hi) is its middle element
+    class StopSpatialIndex {
+    public:
+        struct Neighbor {
+            StopId id;
+            double distance;  // meters
+        };
+
+        StopSpatialIndex() = default;
+        explicit StopSpatialIndex(const geo::PointTable& points);
+
+        // Restores a tree from the order of a previously built one (see snapshot.h)
+        StopSpatialIndex(const geo::PointTable& points, std::vector<StopId> order);
+
+        // Stops no farther than radius meters from center, nearest first, at most limit of them
+        [[nodiscard]] std::vector<Neighbor> Find(geo::Coordinates center,
+                                                 double radius = std::numeric_limits<double>::infinity(),
+                                                 size_t limit = std::numeric_limits<size_t>::max()) const;
+
+        [[nodiscard]] size_t Size() const { return nodes_.size(); }
+        [[nodiscard]] bool Empty() const { return nodes_.empty(); }
+
+        // Stop IDs in tree order
+        [[nodiscard]] std::vector<StopId> GetOrder() const;
+
+    private:
+        struct Node {
+            geo::UnitVector point;
+            StopId id;
+        };
+
+        class Search;
+
+        void Build(size_t lo, size_t hi, int axis);
+
+        [[nodiscard]] static double Coordinate(const geo::UnitVector& point, int axis) {
+            return axis == 0 ? point.x : axis == 1 ? point.y : point.z;
+        }
+
+        std::vector<Node> nodes_;
+    };
+
+} // namespace transport_catalogue
@@ -2,8 +2,9 @@
 
 #include <cstdint>
 #include <iostream>
-#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <variant>
@@ -19,6 +20,8 @@ namespace transport_catalogue::svg {
         uint8_t red = 0;
         uint8_t green = 0;
         uint8_t blue = 0;
+
+        bool operator==(const Rgb&) const = default;
     };
 
     struct Rgba {
@@ -30,6 +33,8 @@ namespace transport_catalogue::svg {
         uint8_t green = 0;
         uint8_t blue = 0;
         double opacity = 1.0;
+
+        bool operator==(const Rgba&) const = default;
     };
 
     using Color = std::variant<
@@ -70,51 +75,54 @@ namespace transport_catalogue::svg {
     };
 
 /*
- * Вспомогательная структура, хранящая контекст для вывода SVG-документа с отступами.
- * Хранит ссылку на поток вывода, текущее значение и шаг отступа при выводе элемента
+ * Атрибуты заливки и обводки элемента. Документ хранит каждый различный набор
+ * один раз, а элементы ссылаются на него по номеру
  */
-    struct RenderContext {
-        RenderContext(std::ostream& out)
-                : out(out) {
-        }
-
-        RenderContext(std::ostream& out, int indent_step, int indent = 0)
-                : out(out)
-                , indent_step(indent_step)
-                , indent(indent) {
-        }
-
-        [[nodiscard]] RenderContext Indented() const {
-            return {out, indent_step, indent + indent_step};
-        }
-
-        void RenderIndent() const {
-            for (int i = 0; i < indent; ++i) {
-                out.put(' ');
-            }
-        }
-
-        std::ostream& out;
-        int indent_step = 0;
-        int indent = 0;
+    struct PathStyle {
+        std::optional<Color> fill_color;
+        std::optional<Color> stroke_color;
+        std::optional<StrokeLineCap> stroke_line_cap;
+        std::optional<StrokeLineJoin> stroke_line_join;
+        std::optional<double> stroke_width;
+
+        bool operator==(const PathStyle&) const = default;
     };
 
 /*
- * Абстрактный базовый класс Object служит для унифицированного хранения
- * конкретных тегов SVG-документа
- * Реализует паттерн "Шаблонный метод" для вывода содержимого тега
+ * Буферизованный вывод SVG-текста. Копит текст во внутреннем буфере и передаёт его
+ * в поток крупными блоками: только когда буфер заполнен, в Flush и в деструкторе
  */
-    class Object {
+    class Writer {
     public:
-        void Render(const RenderContext& context) const;
+        explicit Writer(std::ostream& out);
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+        ~Writer();
+
+        Writer& operator<<(std::string_view text);
+        Writer& operator<<(const std::string& text) { return *this << std::string_view(text); }
+        Writer& operator<<(const char* text) { return *this << std::string_view(text); }
+        Writer& operator<<(char c);
+        Writer& operator<<(int value);
+        Writer& operator<<(uint32_t value);
+        // Так же, как std::ostream с настройками по умолчанию: 6 значащих цифр, формат %g
+        Writer& operator<<(double value);
+        Writer& operator<<(const Color& color);
+        Writer& operator<<(StrokeLineCap cap);
+        Writer& operator<<(StrokeLineJoin join);
+
+        // Выводит текст, заменяя служебные символы XML сущностями
+        void WriteEscaped(std::string_view text);
+
+        void Flush();
 
-        virtual ~Object() = default;
+    private:
+        static constexpr size_t BUFFER_SIZE = 64 * 1024;
 
-    protected:
-        virtual void RenderObject(const RenderContext& context) const = 0;
+        std::ostream& out_;
+        std::string buffer_;
     };
 
-
 /*
  * Класс PathProps реализует общие свойства для тегов, которые могут
  * иметь атрибуты fill и stroke. Он используется в Circle и других тегах,
@@ -124,72 +132,50 @@ namespace transport_catalogue::svg {
     class PathProps {
     public:
         Owner& SetFillColor(Color fill_color) {
-            fill_color_ = std::move(fill_color);
+            style_.fill_color = std::move(fill_color);
             return static_cast<Owner&>(*this);
         }
 
         Owner& SetStrokeColor(Color stroke_color) {
-            stroke_color_ = std::move(stroke_color);
+            style_.stroke_color = std::move(stroke_color);
             return static_cast<Owner&>(*this);
         }
 
         Owner& SetStrokeLineCap(StrokeLineCap stroke_line_cap) {
-            stroke_line_cap_ = stroke_line_cap;
+            style_.stroke_line_cap = stroke_line_cap;
             return static_cast<Owner&>(*this);
         }
 
         Owner& SetStrokeLineJoin(StrokeLineJoin stroke_line_join) {
-            stroke_line_join_ = stroke_line_join;
+            style_.stroke_line_join = stroke_line_join;
             return static_cast<Owner&>(*this);
         }
 
         Owner& SetStrokeWidth(double stroke_width) {
-            stroke_width_ = stroke_width;
+            style_.stroke_width = stroke_width;
             return static_cast<Owner&>(*this);
         }
 
+        [[nodiscard]] const PathStyle& GetPathStyle() const { return style_; }
+
     protected:
         ~PathProps() = default;
 
-        void RenderAttrs(std::ostream& out) const {
-            using namespace std::literals;
-
-            if (fill_color_) {
-                out << " fill=\""sv << *fill_color_ << "\""sv;
-            }
-            if (stroke_color_) {
-                out << " stroke=\""sv << *stroke_color_ << "\""sv;
-            }
-            if (stroke_line_cap_) {
-                out << " stroke-linecap=\""sv << *stroke_line_cap_ << "\""sv;
-            }
-            if (stroke_line_join_) {
-                out << " stroke-linejoin=\""sv << *stroke_line_join_ << "\""sv;
-            }
-            if (stroke_width_) {
-                out << " stroke-width=\""sv << *stroke_width_ << "\""sv;
-            }
-        }
-
     private:
-        std::optional<Color> fill_color_;
-        std::optional<Color> stroke_color_;
-        std::optional<StrokeLineCap> stroke_line_cap_;
-        std::optional<StrokeLineJoin> stroke_line_join_;
-        std::optional<double> stroke_width_;
+        PathStyle style_;
     };
 
 /*
  * Класс Circle моделирует элемент <circle> для отображения круга
  * https://developer.mozilla.org/en-US/docs/Web/SVG/Element/circle
  */
-    class Circle final : public Object, public PathProps<Circle>  {
+    class Circle final : public PathProps<Circle>  {
     public:
         Circle& SetCenter(Point center);
         Circle& SetRadius(double radius);
 
     private:
-        void RenderObject(const RenderContext& context) const override;
+        friend class Document;
 
         Point center_;
         double radius_ = 1.0;
@@ -199,12 +185,12 @@ namespace transport_catalogue::svg {
  * Класс Polyline моделирует элемент <polyline> для отображения ломаных линий
  * https://developer.mozilla.org/en-US/docs/Web/SVG/Element/polyline
  */
-    class Polyline final : public Object, public PathProps<Polyline> {
+    class Polyline final : public PathProps<Polyline> {
     public:
         Polyline& AddPoint(Point point);
 
     private:
-        void RenderObject(const RenderContext& context) const override;
+        friend class Document;
 
         std::vector<Point> points_;
     };
@@ -213,7 +199,7 @@ namespace transport_catalogue::svg {
  * Класс Text моделирует элемент <text> для отображения текста
  * https://developer.mozilla.org/en-US/docs/Web/SVG/Element/text
  */
-    class Text final : public Object, public PathProps<Text> {
+    class Text final : public PathProps<Text> {
     public:
         // Задаёт координаты опорной точки (атрибуты x и y)
         Text& SetPosition(Point pos);
@@ -234,9 +220,7 @@ namespace transport_catalogue::svg {
         Text& SetData(std::string data);
 
     private:
-        void RenderObject(const RenderContext& context) const override;
-
-        [[nodiscard]] static std::string EscapeText(const std::string& data) ;
+        friend class Document;
 
         Point position_;
         Point offset_;
@@ -246,40 +230,92 @@ namespace transport_catalogue::svg {
         std::string data_;
     };
 
-    class ObjectContainer {
-    public:
-        virtual ~ObjectContainer() = default;
-
-        // Добавляет объект в контейнер
-        template <typename Obj>
-        void Add(Obj obj) {
-            AddPtr(std::make_unique<Obj>(std::move(obj)));
-        }
-
-        // Добавляет объект в контейнер, принимая уникальный указатель на объект
-        virtual void AddPtr(std::unique_ptr<Object>&& obj) = 0;
-    };
-
-    class Drawable {
-    public:
-        virtual ~Drawable() = default;
-
-        // Отрисовывает объект в контексте вывода
-        virtual void Draw(ObjectContainer& container) const = 0;
-    };
-
-    class Document : public ObjectContainer {
+/*
+ * SVG-документ. Элементы не хранятся по отдельности: Add раскладывает их по плотным
+ * массивам записей каждого вида, точки всех ломаных лежат в одном массиве, тексты надписей —
+ * в одной строке, а наборы атрибутов и шрифты хранятся по одному разу. Порядок вывода
+ * элементов совпадает с порядком добавления
+ */
+    class Document {
     public:
         Document() = default;
 
-        // Добавляет в svg-документ объект-наследник svg::Object
-        void AddPtr(std::unique_ptr<Object>&& obj) override;
+        void Add(const Circle& circle);
+        void Add(const Polyline& polyline);
+        void Add(const Text& text);
+
+        // Число добавленных элементов
+        [[nodiscard]] size_t GetObjectCount() const { return items_.size(); }
 
         // Выводит в ostream svg-представление документа
         void Render(std::ostream& out) const;
+        void Render(Writer& out) const;
+
+        // Части вывода Render: заголовок, элементы, закрывающий тег. Один svg можно составить
+        // из нескольких документов, выведя между заголовком и тегом элементы каждого по очереди
+        static void RenderBegin(Writer& out);
+        void RenderObjects(Writer& out) const;
+        static void RenderEnd(Writer& out);
 
     private:
-        std::vector<std::unique_ptr<Object>> objects_;
+        enum class Kind : uint8_t {
+            CIRCLE,
+            POLYLINE,
+            TEXT,
+        };
+
+        // Элемент в порядке вывода: вид и номер записи в массиве этого вида
+        struct Item {
+            Kind kind;
+            uint32_t index;
+        };
+
+        struct CircleRecord {
+            Point center;
+            double radius;
+            uint32_t style;
+        };
+
+        struct PolylineRecord {
+            uint32_t first_point;
+            uint32_t point_count;
+            uint32_t style;
+        };
+
+        struct TextRecord {
+            Point position;
+            Point offset;
+            uint32_t font_size;
+            uint32_t font;
+            uint32_t style;
+            uint32_t data_offset;
+            uint32_t data_size;
+        };
+
+        struct Font {
+            std::string family;
+            std::string weight;
+
+            bool operator==(const Font&) const = default;
+        };
+
+        struct PathStyleHasher {
+            size_t operator()(const PathStyle& style) const;
+        };
+
+        [[nodiscard]] uint32_t InternStyle(const PathStyle& style);
+        [[nodiscard]] uint32_t InternFont(const std::string& family, const std::string& weight);
+
+        std::vector<Item> items_;
+        std::vector<CircleRecord> circles_;
+        std::vector<PolylineRecord> polylines_;
+        std::vector<Point> points_;
+        std::vector<TextRecord> texts_;
+        std::string text_data_;
+
+        std::vector<PathStyle> styles_;
+        std::unordered_map<PathStyle, uint32_t, PathStyleHasher> style_ids_;
+        std::vector<Font> fonts_;
     };
 
-}  // namespace transport_catalogue::svg
\ No newline at end of file
+}  // namespace transport_catalogue::svg
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace transport_catalogue {
+
+    // A fixed set of worker threads for data-parallel loops. The thread calling ParallelFor()
+    // takes part in the loop too, so a pool of N threads starts N - 1 workers
+    class ThreadPool {
+    public:
+        // 0 means one thread per hardware core
+        explicit ThreadPool(size_t thread_count = 0);
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ~ThreadPool();
+
+        [[nodiscard]] size_t GetThreadCount() const { return workers_.size() + 1; }
+
+        // Calls body(i) for every i in [0, count) and returns once all calls are done.
+        // Indices are handed out one by one, so uneven calls still spread over the threads.
+        // The first exception thrown by body is rethrown here after the loop stops.
+        // Loops are run one at a time: ParallelFor() is not meant to be called concurrently,
+        // except from inside a body of this pool, where the inner loop runs in the calling thread
+        void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    private:
+        void WorkerLoop();
+        // Runs indices of the current loop until there are none left
+        void RunIndices();
+
+        std::vector<std::thread> workers_;
+
+        std::mutex mutex_;
+        std::condition_variable work_ready_;
+        std::condition_variable work_done_;
+        // Bumped for every loop so that a worker joins each loop at most once
+        size_t generation_ = 0;
+        size_t busy_workers_ = 0;
+        bool stopping_ = false;
+
+        const std::function<void(size_t)>* body_ = nullptr;
+        size_t count_ = 0;
+        std::atomic<size_t> next_index_ = 0;
+        std::exception_ptr error_;
+    };
+
+} // namespace transport_catalogue
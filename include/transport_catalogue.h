@@ -1,23 +1,22 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <deque>
 #include <unordered_map>
-#include <unordered_set>
 #include <optional>
+#include <span>
 
 #include "domain.h"
+#include "perfect_hash.h"
+#include "spatial_index.h"
 
 namespace transport_catalogue {
 
-    struct PtrPairHasher {
-        size_t operator()(const std::pair<const void*, const void*>& p) const {
-            size_t h1 = std::hash<const void*>{}(p.first);
-            size_t h2 = std::hash<const void*>{}(p.second);
-            return h1 + 37 * h2;
-        }
-    };
+    namespace snapshot {
+        class Access;
+    }
 
     class TransportCatalogue {
     public:
@@ -36,27 +35,112 @@ namespace transport_catalogue {
         // Returns bus information if it exists, otherwise returns std::nullopt.
         [[nodiscard]] std::optional<BusInfo> GetBusInfo(const std::string_view& bus_name) const;
 
-        // Returns a list of buses that pass through a given stop.
-        [[nodiscard]] const std::unordered_set<const Bus*>& GetBusesForStop(const Stop *stop) const;
+        // Returns the buses that pass through a given stop, sorted by name without duplicates.
+        [[nodiscard]] std::span<const Bus* const> GetBusesForStop(const Stop *stop) const;
 
         // Sets the distance between two stops.
         void SetDistance(const Stop *from, const Stop *to, double distance);
 
         // Gets the distance between two stops.
         [[nodiscard]] double GetDistance(const Stop *from, const Stop *to) const;
+        [[nodiscard]] double GetDistance(StopId from, StopId to) const;
+
+        // Stops no farther than radius meters from center, nearest first, at most limit of them.
+        // Uses the spatial index built by Freeze(), scans all stops otherwise
+        [[nodiscard]] std::vector<StopDistance> FindNearbyStops(geo::Coordinates center, double radius,
+                                                                size_t limit) const;
+
+        // Packs the distances set so far into the compact read-only layout, precomputes
+        // BusInfo of every bus, builds the spatial index of stops and replaces the name indexes with perfect hash tables.
+        // Call once loading is done; the catalogue can still be changed afterwards,
+        // but queries get slower until the next Freeze()
+        void Freeze();
 
         // Public accessors for buses and stops
         [[nodiscard]] const std::deque<Bus>& GetAllBuses() const { return buses_; }
         [[nodiscard]] const std::deque<Stop>& GetAllStops() const { return stops_; }
 
+        // ID-based access. Stop and bus IDs are dense: [0, GetStopCount()) and [0, GetBusCount())
+        [[nodiscard]] size_t GetStopCount() const { return stops_.size(); }
+        [[nodiscard]] size_t GetBusCount() const { return buses_.size(); }
+        [[nodiscard]] const Stop& GetStop(StopId id) const { return stops_[id]; }
+        [[nodiscard]] const Bus& GetBus(BusId id) const { return buses_[id]; }
+
+        // Coordinates of all stops, indexed by StopId
+        [[nodiscard]] std::span<const geo::Coordinates> GetStopCoordinates() const { return stop_coordinates_; }
+
+        // Stop IDs of a bus route in the order they were added (without the way back)
+        [[nodiscard]] std::span<const StopId> GetRoute(BusId id) const;
+
+        // Changes whenever stops, buses or distances change. Versions are unique across
+        // all catalogues of the process, so results computed from a catalogue can be cached by it
+        [[nodiscard]] uint64_t GetVersion() const { return version_; }
+
     private:
+        // Reads and writes the internal arrays for binary snapshots
+        friend class snapshot::Access;
+
+        struct RoadDistance {
+            StopId to;
+            double distance;
+        };
+
+        [[nodiscard]] static uint64_t DistanceKey(StopId from, StopId to) {
+            return uint64_t{from} << 32 | to;
+        }
+
+        static void AddBusToStop(std::vector<const Bus*>& buses, const Bus* bus);
+        [[nodiscard]] static uint64_t NextVersion();
+        void FreezeDistances();
+        void FreezeNames();
+        // Brings back the mutable name indexes released by Freeze()
+        void ThawNames();
+        [[nodiscard]] BusInfo ComputeBusInfo(const Bus& bus) const;
+
+        // Distance explicitly set for from -> to, if any
+        [[nodiscard]] std::optional<double> FindDistance(StopId from, StopId to) const;
+
+        // Whether the pointer refers to a stop owned by this catalogue
+        [[nodiscard]] bool OwnsStop(const Stop* stop) const {
+            return stop && stop->id < stops_.size() && &stops_[stop->id] == stop;
+        }
+
+        // Name indexes: hash maps while the catalogue is being filled,
+        // perfect hash tables after Freeze()
         std::unordered_map<std::string_view, const Stop *> stops_index_;
         std::unordered_map<std::string_view, const Bus *> buses_index_;
-        std::unordered_map<const Stop *, std::unordered_set<const Bus*>> stop_to_buses_;
+        PerfectHashIndex stops_names_;
+        PerfectHashIndex buses_names_;
+        bool names_frozen_ = false;
+
+        // Stop and Bus objects back the pointer API; deque keeps their addresses stable
         std::deque<Stop> stops_;
         std::deque<Bus> buses_;
 
-        std::unordered_map<std::pair<const Stop*, const Stop*>, double, PtrPairHasher> distances_;
+        // Struct-of-arrays data for hot loops, indexed by StopId / BusId.
+        // Routes of all buses are stored back to back: route of bus i is
+        // route_stops_[route_offsets_[i], route_offsets_[i + 1])
+        std::vector<geo::Coordinates> stop_coordinates_;
+        geo::PointTable stop_points_;
+        std::vector<std::vector<const Bus*>> stop_to_buses_;
+        std::vector<StopId> route_stops_;
+        std::vector<uint32_t> route_offsets_{0};
+
+        // Road distances in compressed sparse row form: distances from stop i are
+        // distances_[distance_offsets_[i], distance_offsets_[i + 1]), sorted by RoadDistance::to.
+        // Built by Freeze(); distances set after that are kept in pending_distances_
+        std::vector<uint32_t> distance_offsets_;
+        std::vector<RoadDistance> distances_;
+        std::unordered_map<uint64_t, double> pending_distances_;
+
+        // BusInfo by BusId, filled by Freeze(). Any change of routes or distances clears it,
+        // and GetBusInfo falls back to computing the statistics on each call
+        std::vector<BusInfo> bus_infos_;
+
+        // KD-tree over stop_points_, built by Freeze() and dropped when a stop is added
+        StopSpatialIndex spatial_index_;
+
+        uint64_t version_ = NextVersion();
     };
 
 } // namespace transport_catalogue
\ No newline at end of file
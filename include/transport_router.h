@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <variant>
+#include <vector>
+
+#include "domain.h"
+#include "graph.h"
+#include "landmarks.h"
+#include "router.h"
+#include "transport_catalogue.h"
+
+namespace transport_catalogue::router {
+
+    struct RoutingSettings {
+        double bus_wait_time = 0.0;  // minutes
+        double bus_velocity = 0.0;   // km/h
+
+        bool operator==(const RoutingSettings&) const = default;
+    };
+
+    // Waiting for a bus at a stop
+    struct WaitItem {
+        const Stop* stop;
+        double time;
+    };
+
+    // Riding one bus for span_count stops
+    struct BusItem {
+        const Bus* bus;
+        int span_count;
+        double time;
+    };
+
+    using RouteItem = std::variant<WaitItem, BusItem>;
+
+    struct RouteInfo {
+        double total_time = 0.0;  // minutes
+        std::vector<RouteItem> items;
+    };
+
+    // Fastest journeys between stops. The graph is built once from the bus routes and
+    // road distances of a frozen catalogue and shared by all queries.
+    //
+    // Every stop is a vertex where a passenger stands between buses. Every position of
+    // every bus route (the way back included for non-roundtrip buses) is a vertex too:
+    //   stop -> position     boarding, costs bus_wait_time;
+    //   position -> next     riding to the next stop of the route, distance / bus_velocity;
+    //   position -> stop     getting off, free.
+    // The graph stays linear in the total length of routes, and a ride of several stops
+    // is a run of consecutive ride edges, which gives span_count directly
+    class TransportRouter {
+    public:
+        TransportRouter(const TransportCatalogue& db, RoutingSettings settings);
+
+        // router_ refers to graph_
+        TransportRouter(const TransportRouter&) = delete;
+        TransportRouter& operator=(const TransportRouter&) = delete;
+
+        // Fastest journey from one stop to another, std::nullopt if there is none.
+        // Uses A* over the landmark index when there is one, Dijkstra otherwise
+        [[nodiscard]] std::optional<RouteInfo> BuildRoute(const Stop* from, const Stop* to) const;
+
+        // Preprocesses the graph into a landmark index, which makes each query visit
+        // a much smaller part of the graph
+        void BuildIndex();
+
+        // Uses an index built earlier (e.g. loaded from a snapshot).
+        // Throws std::invalid_argument if it was built for another graph
+        void SetIndex(graph::Landmarks index);
+
+        // Same, but an index of another graph is left unused and false is returned.
+        // A saved index stops fitting once the catalogue is extended after loading
+        bool TrySetIndex(graph::Landmarks index);
+
+        // The landmark index, nullptr before BuildIndex() or SetIndex()
+        [[nodiscard]] const graph::Landmarks* GetIndex() const { return index_ ? &*index_ : nullptr; }
+
+        [[nodiscard]] const RoutingSettings& GetSettings() const { return settings_; }
+        [[nodiscard]] const graph::DirectedWeightedGraph<double>& GetGraph() const { return graph_; }
+
+    private:
+        enum class EdgeKind : uint8_t { Board, Ride, Alight };
+
+        struct EdgeInfo {
+            EdgeKind kind;
+            uint32_t object;  // StopId for Board and Alight, BusId for Ride
+        };
+
+        void BuildGraph();
+
+        // Turns a path of graph edges into Wait and Bus items
+        [[nodiscard]] RouteInfo MakeRouteInfo(double total_time, std::span<const graph::EdgeId> edges) const;
+
+        const TransportCatalogue& db_;
+        RoutingSettings settings_;
+        graph::DirectedWeightedGraph<double> graph_;
+        std::vector<EdgeInfo> edge_infos_;  // by EdgeId
+        graph::Router<double> router_{graph_};
+        std::optional<graph::Landmarks> index_;
+    };
+
+} // namespace transport_catalogue::router
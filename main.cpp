@@ -1,29 +1,137 @@
+#include <charconv>
 #include <iostream>
+#include <iterator>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <stdexcept>
+#include <system_error>
 
 #include "map_renderer.h"
 #include "json_reader.h"
 #include "request_handler.h"
+#include "snapshot.h"
+#include "thread_pool.h"
+#include "transport_router.h"
 
 using namespace std;
 using namespace transport_catalogue;
 
-int main() {
+// Usage:
+//   transport_catalogue                        read everything from the JSON on stdin
+//   transport_catalogue --save-snapshot FILE   also save the built catalogue to FILE
+//   transport_catalogue --load-snapshot FILE   take the catalogue (and render and routing settings,
+//                                              unless stdin has its own) from FILE
+//   transport_catalogue --route-index          preprocess the routing graph into a landmark index
+//                                              for faster Route requests; it is saved to and
+//                                              loaded from snapshots
+//   transport_catalogue --threads N            answer stat requests and render maps on N threads
+//                                              (0: one per core, at most 1024); answers come out
+//                                              in the order of the requests
+//   transport_catalogue --structural-scan      parse the input with a vectorised index of quotes and
+//                                              structural characters (json::ScanMode::Structural);
+//                                              pays off on inputs with long strings
+// The N of --threads: a plain decimal number no larger than MAX_THREADS
+static bool ParseThreadCount(string_view text, size_t& count) {
+    constexpr size_t MAX_THREADS = 1024;
+    size_t value = 0;
+    const auto [end, error] = from_chars(text.data(), text.data() + text.size(), value);
+    if (error != errc{} || end != text.data() + text.size() || value > MAX_THREADS) {
+        return false;
+    }
+    count = value;
+    return true;
+}
+
+int main(int argc, char** argv) {
     using namespace json;
 
-    Document doc = Load(cin);
+    string save_path;
+    string load_path;
+    bool route_index = false;
+    ScanMode scan_mode = ScanMode::Scalar;
+    size_t thread_count = 1;
+    for (int i = 1; i < argc; ++i) {
+        const string_view arg = argv[i];
+        if (arg == "--save-snapshot"sv && i + 1 < argc) {
+            save_path = argv[++i];
+        } else if (arg == "--load-snapshot"sv && i + 1 < argc) {
+            load_path = argv[++i];
+        } else if (arg == "--route-index"sv) {
+            route_index = true;
+        } else if (arg == "--structural-scan"sv) {
+            scan_mode = ScanMode::Structural;
+        } else if (arg == "--threads"sv && i + 1 < argc && ParseThreadCount(argv[i + 1], thread_count)) {
+            ++i;
+        } else {
+            cerr << "Usage: " << argv[0]
+                 << " [--save-snapshot FILE | --load-snapshot FILE] [--route-index] [--threads N] [--structural-scan] < input.json" << endl;
+            return 1;
+        }
+    }
+
+    const string input{istreambuf_iterator<char>(cin), istreambuf_iterator<char>()};
 
     TransportCatalogue catalogue;
-    JsonReader reader(doc, catalogue);
+    Node snapshot_render_settings;
+    optional<snapshot::RouteIndex> snapshot_route_index;
+    if (!load_path.empty()) {
+        snapshot_render_settings = snapshot::LoadFromFile(load_path, catalogue, &snapshot_route_index);
+    }
+
+    JsonReader reader(string_view(input), catalogue, scan_mode);
     reader.ProcessBaseRequests();
+    if (reader.GetRenderSettings().IsNull()) {
+        reader.SetRenderSettings(move(snapshot_render_settings));
+    }
+
+    // The routing graph is built once here and shared by all Route requests
+    optional<router::TransportRouter> transport_router;
+    auto routing_settings = reader.GetRoutingSettings();
+    if (!routing_settings && snapshot_route_index) {
+        routing_settings = snapshot_route_index->settings;
+    }
+    if (routing_settings) {
+        // Bad settings (e.g. no bus_velocity) fail only Route requests, not the whole batch
+        try {
+            transport_router.emplace(catalogue, *routing_settings);
+        } catch (const invalid_argument& e) {
+            cerr << e.what() << "; every Route request is answered \"not found\"" << endl;
+        }
+    }
+    if (transport_router) {
+        // A saved index only fits the graph built with the same settings from the same
+        // stops and buses; base requests added after loading change the graph
+        bool has_index = false;
+        if (snapshot_route_index && snapshot_route_index->landmarks
+            && snapshot_route_index->settings == *routing_settings) {
+            has_index = transport_router->TrySetIndex(move(*snapshot_route_index->landmarks));
+            if (!has_index) {
+                cerr << "The saved route index does not fit the extended catalogue and is not used" << endl;
+            }
+        }
+        if (!has_index && route_index) {
+            transport_router->BuildIndex();
+        }
+    }
+
+    if (!save_path.empty()) {
+        snapshot::SaveToFile(catalogue, reader.GetRenderSettings(), save_path,
+                             transport_router ? &*transport_router : nullptr);
+    }
+
+    optional<ThreadPool> pool;
+    if (thread_count != 1) {
+        pool.emplace(thread_count);
+    }
 
     renderer::MapRenderer renderer;
     reader.ProcessRenderSettings(renderer);
+    renderer.SetThreadPool(pool ? &*pool : nullptr);
 
-    RequestHandler handler(catalogue, renderer);
+    RequestHandler handler(catalogue, renderer, transport_router ? &*transport_router : nullptr);
 
-    Array responses = reader.ProcessStatRequests(handler);
-    Document response_doc{Node{responses}};
-    Print(response_doc, cout);
+    Writer writer(cout);
+    reader.ProcessStatRequests(handler, writer, pool ? &*pool : nullptr);
 }
@@ -1,8 +1,16 @@
 #define _USE_MATH_DEFINES
 #include "geo.h"
 
+#include <algorithm>
 #include <cmath>
 
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GEO_X86_SIMD 1
+#else
+#define GEO_X86_SIMD 0
+#endif
+
 namespace transport_catalogue::geo {
 
 double ComputeDistance(Coordinates from, Coordinates to) {
@@ -13,4 +21,133 @@ double ComputeDistance(Coordinates from, Coordinates to) {
         * 6371000;
 }
 
-}  // namespace transport_catalogue::geo
\ No newline at end of file
+namespace {
+
+constexpr double EARTH_RADIUS = 6371000;
+
+// Rational approximation of asin on [0, 0.625] (Cephes), accurate to a couple of ulp:
+// asin(x) = x + x * z * P(z) / Q(z), z = x * x
+constexpr double ASIN_P[] = {4.253011369004428248960E-3, -6.019598008014123785661E-1, 5.444622390564711410273E0,
+                             -1.626247967210700244449E1, 1.956261983317594739197E1, -8.198089802484824371615E0};
+constexpr double ASIN_Q[] = {1.0, -1.474091372988853791896E1, 7.049610280856842141659E1,
+                             -1.471791292232726029859E2, 1.395105614657485689735E2, -4.918853881490881290097E1};
+
+// Central angle from the half chord h = sin(angle / 2), 0 <= h <= 1.
+// For h > 0.5 the identity asin(h) = pi/2 - 2 asin(sqrt((1 - h) / 2)) keeps the argument in range.
+// The AVX2 version below runs the same sequence of operations; the two agree to within rounding,
+// exactly so unless the compiler contracts the scalar multiply-adds into FMA
+double AngleFromHalfChord(double h) {
+    const bool reflect = h > 0.5;
+    const double t = reflect ? std::sqrt((1.0 - h) * 0.5) : h;
+    const double z = t * t;
+    double p = ASIN_P[0];
+    double q = ASIN_Q[0];
+    for (int i = 1; i < 6; ++i) {
+        p = p * z + ASIN_P[i];
+        q = q * z + ASIN_Q[i];
+    }
+    const double a = t + t * (z * p / q);
+    const double asin_h = reflect ? M_PI_2 - (a + a) : a;
+    return asin_h + asin_h;
+}
+
+double SegmentLength(const double* x, const double* y, const double* z, uint32_t from, uint32_t to) {
+    const double dx = x[from] - x[to];
+    const double dy = y[from] - y[to];
+    const double dz = z[from] - z[to];
+    const double h = std::min(std::sqrt(dx * dx + dy * dy + dz * dz) * 0.5, 1.0);
+    return AngleFromHalfChord(h) * EARTH_RADIUS;
+}
+
+#if GEO_X86_SIMD
+// The unmasked gather leaves its source operand undefined, which GCC reports as maybe-uninitialized
+__attribute__((target("avx2")))
+inline __m256d Gather(const double* base, __m128i index) {
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, index,
+                                    _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+}
+
+__attribute__((target("avx2")))
+size_t ComputeDistancesAvx2(const double* x, const double* y, const double* z, const uint32_t* from,
+                            const uint32_t* to, double* out, size_t count) {
+    const size_t blocks = count / 4 * 4;
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d half_pi = _mm256_set1_pd(M_PI_2);
+    const __m256d radius = _mm256_set1_pd(EARTH_RADIUS);
+    for (size_t i = 0; i < blocks; i += 4) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(to + i));
+        // Indices are unsigned; gathers take signed ones, which is fine below 2^31 points
+        const __m256d dx = _mm256_sub_pd(Gather(x, a), Gather(x, b));
+        const __m256d dy = _mm256_sub_pd(Gather(y, a), Gather(y, b));
+        const __m256d dz = _mm256_sub_pd(Gather(z, a), Gather(z, b));
+        const __m256d chord2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)),
+                                             _mm256_mul_pd(dz, dz));
+        const __m256d h = _mm256_min_pd(_mm256_mul_pd(_mm256_sqrt_pd(chord2), half), one);
+
+        const __m256d reflect = _mm256_cmp_pd(h, half, _CMP_GT_OQ);
+        const __m256d t = _mm256_blendv_pd(h, _mm256_sqrt_pd(_mm256_mul_pd(_mm256_sub_pd(one, h), half)), reflect);
+        const __m256d zz = _mm256_mul_pd(t, t);
+        __m256d p = _mm256_set1_pd(ASIN_P[0]);
+        __m256d q = _mm256_set1_pd(ASIN_Q[0]);
+        for (int k = 1; k < 6; ++k) {
+            p = _mm256_add_pd(_mm256_mul_pd(p, zz), _mm256_set1_pd(ASIN_P[k]));
+            q = _mm256_add_pd(_mm256_mul_pd(q, zz), _mm256_set1_pd(ASIN_Q[k]));
+        }
+        const __m256d poly = _mm256_add_pd(t, _mm256_mul_pd(t, _mm256_div_pd(_mm256_mul_pd(zz, p), q)));
+        const __m256d asin_h = _mm256_blendv_pd(poly, _mm256_sub_pd(half_pi, _mm256_add_pd(poly, poly)), reflect);
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_add_pd(asin_h, asin_h), radius));
+    }
+    return blocks;
+}
+#endif
+
+} // namespace
+
+UnitVector ToUnitVector(Coordinates point) {
+    const double dr = M_PI / 180.0;
+    const double cos_lat = std::cos(point.lat * dr);
+    return {cos_lat * std::cos(point.lng * dr), cos_lat * std::sin(point.lng * dr), std::sin(point.lat * dr)};
+}
+
+double ChordToDistance(double chord) {
+    return AngleFromHalfChord(std::min(chord * 0.5, 1.0)) * EARTH_RADIUS;
+}
+
+double DistanceToChord(double distance) {
+    return 2.0 * std::sin(std::min(distance / EARTH_RADIUS, M_PI) * 0.5);
+}
+
+PointTable::PointTable(std::span<const Coordinates> points) {
+    x_.reserve(points.size());
+    y_.reserve(points.size());
+    z_.reserve(points.size());
+    for (const Coordinates& point : points) {
+        Add(point);
+    }
+}
+
+void PointTable::Add(Coordinates point) {
+    const UnitVector v = ToUnitVector(point);
+    x_.push_back(v.x);
+    y_.push_back(v.y);
+    z_.push_back(v.z);
+}
+
+void ComputeDistances(const PointTable& points, std::span<const uint32_t> from, std::span<const uint32_t> to,
+                      std::span<double> out) {
+    const size_t count = std::min({from.size(), to.size(), out.size()});
+    size_t done = 0;
+#if GEO_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        done = ComputeDistancesAvx2(points.x_.data(), points.y_.data(), points.z_.data(), from.data(), to.data(),
+                                    out.data(), count);
+    }
+#endif
+    for (size_t i = done; i < count; ++i) {
+        out[i] = SegmentLength(points.x_.data(), points.y_.data(), points.z_.data(), from[i], to[i]);
+    }
+}
+
+}  // namespace transport_catalogue::geo
@@ -1,6 +1,19 @@
 #include "json.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <streambuf>
+#include <string_view>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define JSON_X86_SIMD 1
+#else
+#define JSON_X86_SIMD 0
+#endif
 
 namespace json {
 
@@ -18,8 +31,26 @@ namespace json {
             return s;
         }
 
+        // Преобразует проверенную грамматикой запись числа в int или double.
+        // Целое, не помещающееся в int, представляется как double
+        Node ConvertNumber(std::string_view text, bool is_int) {
+            const char* first = text.data();
+            const char* last = first + text.size();
+            if (is_int) {
+                int value = 0;
+                if (auto [ptr, ec] = std::from_chars(first, last, value); ec == std::errc{} && ptr == last) {
+                    return value;
+                }
+            }
+            double value = 0.0;
+            if (auto [ptr, ec] = std::from_chars(first, last, value); ec != std::errc{} || ptr != last) {
+                throw ParsingError("Failed to convert "s + std::string(text) + " to number"s);
+            }
+            return value;
+        }
+
         Node LoadArray(std::istream& input) {
-            std::vector<Node> result;
+            Array result;
 
             for (char c; input >> c && c != ']';) {
                 if (c != ',') {
@@ -174,20 +205,7 @@ namespace json {
                 is_int = false;
             }
 
-            try {
-                if (is_int) {
-                    // Сначала пробуем преобразовать строку в int
-                    try {
-                        return std::stoi(parsed_num);
-                    } catch (...) {
-                        // В случае неудачи, например, при переполнении
-                        // код ниже попробует преобразовать строку в double
-                    }
-                }
-                return std::stod(parsed_num);
-            } catch (...) {
-                throw ParsingError("Failed to convert "s + parsed_num + " to number"s);
-            }
+            return ConvertNumber(parsed_num, is_int);
         }
 
         Node LoadNode(std::istream& input) {
@@ -222,123 +240,452 @@ namespace json {
             }
         }
 
-        struct PrintContext {
-            std::ostream& out;
-            int indent_step = 4;
-            int indent = 0;
+        // ---------- Структурный индекс ----------
+        // Предварительный проход по буферу, отмечающий позиции всех символов,
+        // на которых парсер принимает решения: кавычки, обратные слэши, переводы строк
+        // и структурные символы {}[]:,. Индекс используется только внутри строк: их содержимое
+        // пропускается прыжком по индексу, а не проверкой каждого байта. Между значениями
+        // массивов и словарей стоят лишь пробелы и короткие числа и литералы, которых
+        // в индексе нет, поэтому там разбор по-прежнему идёт по символам
 
-            void PrintIndent() const {
-                for (int i = 0; i < indent; ++i) {
-                    out.put(' ');
+        using StructuralIndex = std::vector<uint32_t>;
+
+        constexpr bool IsIndexed(char c) {
+            switch (c) {
+                case '"': case '\\': case '\n': case '\r':
+                case '{': case '}': case '[': case ']': case ':': case ',':
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        void IndexScalar(std::string_view input, size_t from, StructuralIndex& index) {
+            for (size_t i = from; i < input.size(); ++i) {
+                if (IsIndexed(input[i])) {
+                    index.push_back(static_cast<uint32_t>(i));
                 }
             }
+        }
 
-            PrintContext Indented() const {
-                return {out, indent_step, indent_step + indent};
+#if JSON_X86_SIMD
+        // Дописывает в индекс позиции установленных битов маски
+        inline void AppendMask(StructuralIndex& index, uint32_t base, uint32_t mask) {
+            while (mask != 0) {
+                index.push_back(base + static_cast<uint32_t>(__builtin_ctz(mask)));
+                mask &= mask - 1;
             }
-        };
+        }
+
+        __attribute__((target("avx2")))
+        size_t IndexAvx2(std::string_view input, StructuralIndex& index) {
+            const char* data = input.data();
+            const size_t blocks = input.size() / 32 * 32;
+            const char specials[] = {'"', '\\', '\n', '\r', '{', '}', '[', ']', ':', ','};
+            __m256i needles[std::size(specials)];
+            for (size_t k = 0; k < std::size(specials); ++k) {
+                needles[k] = _mm256_set1_epi8(specials[k]);
+            }
+            for (size_t i = 0; i < blocks; i += 32) {
+                const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i hits = _mm256_cmpeq_epi8(chunk, needles[0]);
+                for (size_t k = 1; k < std::size(specials); ++k) {
+                    hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, needles[k]));
+                }
+                AppendMask(index, static_cast<uint32_t>(i), static_cast<uint32_t>(_mm256_movemask_epi8(hits)));
+            }
+            return blocks;
+        }
 
-        void PrintNode(const Node& value, const PrintContext& ctx);
+        __attribute__((target("sse4.2")))
+        size_t IndexSse42(std::string_view input, StructuralIndex& index) {
+            const char* data = input.data();
+            const size_t blocks = input.size() / 16 * 16;
+            // Набор искомых символов для PCMPESTRM (режим "равен любому из")
+            const __m128i set = _mm_setr_epi8('"', '\\', '\n', '\r', '{', '}', '[', ']', ':', ',', 0, 0, 0, 0, 0, 0);
+            constexpr int set_size = 10;
+            constexpr int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+            for (size_t i = 0; i < blocks; i += 16) {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                const __m128i mask = _mm_cmpestrm(set, set_size, chunk, 16, mode);
+                AppendMask(index, static_cast<uint32_t>(i), static_cast<uint32_t>(_mm_cvtsi128_si32(mask)));
+            }
+            return blocks;
+        }
+#endif
 
-        template <typename Value>
-        void PrintValue(const Value& value, const PrintContext& ctx) {
-            ctx.out << value;
+        StructuralIndex BuildStructuralIndex(std::string_view input) {
+            // Индекс растёт по мере прохода: место под каждый байт входа заранее не выделяется.
+            // Начальная оценка — один отмеченный символ на 8 байт, как у плотного JSON
+            StructuralIndex index;
+            index.reserve(input.size() / 8 + 16);
+            size_t done = 0;
+#if JSON_X86_SIMD
+            if (__builtin_cpu_supports("avx2")) {
+                done = IndexAvx2(input, index);
+            } else if (__builtin_cpu_supports("sse4.2")) {
+                done = IndexSse42(input, index);
+            }
+#endif
+            IndexScalar(input, done, index);
+            return index;
         }
 
-        void PrintString(const std::string& value, std::ostream& out) {
-            out.put('"');
-            for (const char c : value) {
+        // Парсер, работающий с непрерывным буфером в памяти.
+        // Повторяет грамматику и сообщения об ошибках потоковой версии выше,
+        // но читает символы через указатели, без накладных расходов std::istream.
+        // Умеет как строить дерево Node, так и отдавать события в EventHandler
+        class BufferParser {
+        public:
+            explicit BufferParser(std::string_view input, const StructuralIndex* index = nullptr,
+                                  std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+                    : begin_(input.data()), pos_(input.data()), end_(input.data() + input.size())
+                    , index_(index), resource_(resource) {
+            }
+
+            Node LoadNode() {
+                char c;
+                if (!NextNonSpace(c)) {
+                    throw ParsingError("Unexpected EOF"s);
+                }
                 switch (c) {
-                    case '\r':
-                        out << "\\r"sv;
-                        break;
-                    case '\n':
-                        out << "\\n"sv;
+                    case '[':
+                        return LoadArray();
+                    case '{':
+                        return LoadDict();
+                    case '"':
+                        return Node(std::string(ScanString()));
+                    case 't':
+                        [[fallthrough]];
+                    case 'f':
+                        --pos_;
+                        return Node{LoadBool()};
+                    case 'n':
+                        --pos_;
+                        LoadNull();
+                        return Node{nullptr};
+                    default:
+                        --pos_;
+                        return LoadNumber();
+                }
+            }
+
+            void ParseNode(EventHandler& handler) {
+                char c;
+                if (!NextNonSpace(c)) {
+                    throw ParsingError("Unexpected EOF"s);
+                }
+                switch (c) {
+                    case '[':
+                        ParseArray(handler);
                         break;
-                    case '\t':
-                        out << "\\t"sv;
+                    case '{':
+                        ParseDict(handler);
                         break;
                     case '"':
-                        // Символы " и \ выводятся как \" или \\, соответственно
-                        [[fallthrough]];
-                    case '\\':
-                        out.put('\\');
+                        handler.String(ScanString());
+                        break;
+                    case 't':
                         [[fallthrough]];
-                    default:
-                        out.put(c);
+                    case 'f':
+                        --pos_;
+                        handler.Bool(LoadBool());
                         break;
+                    case 'n':
+                        --pos_;
+                        LoadNull();
+                        handler.Null();
+                        break;
+                    default: {
+                        --pos_;
+                        const Node number = LoadNumber();
+                        if (number.IsInt()) {
+                            handler.Int(number.AsInt());
+                        } else {
+                            handler.Double(number.AsDouble());
+                        }
+                    }
                 }
             }
-            out.put('"');
-        }
 
-        template <>
-        void PrintValue<std::string>(const std::string& value, const PrintContext& ctx) {
-            PrintString(value, ctx.out);
-        }
+        private:
+            static bool IsSpace(char c) {
+                return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+            }
 
-        template <>
-        void PrintValue<std::nullptr_t>(const std::nullptr_t&, const PrintContext& ctx) {
-            ctx.out << "null"sv;
-        }
+            static bool IsDigit(char c) {
+                return c >= '0' && c <= '9';
+            }
 
-// В специализации шаблона PrintValue для типа bool параметр value передаётся
-// по константной ссылке, как и в основном шаблоне.
-// В качестве альтернативы можно использовать перегрузку:
-// void PrintValue(bool value, const PrintContext& ctx);
-        template <>
-        void PrintValue<bool>(const bool& value, const PrintContext& ctx) {
-            ctx.out << (value ? "true"sv : "false"sv);
-        }
+            static bool IsAlpha(char c) {
+                return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            }
+
+            // Аналог input >> c: пропускает пробельные символы и считывает следующий
+            bool NextNonSpace(char& c) {
+                while (pos_ != end_ && IsSpace(*pos_)) {
+                    ++pos_;
+                }
+                if (pos_ == end_) {
+                    return false;
+                }
+                c = *pos_++;
+                return true;
+            }
+
+            std::string_view LoadLiteral() {
+                const char* begin = pos_;
+                while (pos_ != end_ && IsAlpha(*pos_)) {
+                    ++pos_;
+                }
+                return {begin, static_cast<size_t>(pos_ - begin)};
+            }
+
+            Node LoadArray() {
+                Array result(resource_);
+
+                char c;
+                bool ok;
+                while ((ok = NextNonSpace(c)) && c != ']') {
+                    if (c != ',') {
+                        --pos_;
+                    }
+                    result.push_back(LoadNode());
+                }
+                if (!ok) {
+                    throw ParsingError("Array parsing error"s);
+                }
+                return Node(std::move(result));
+            }
+
+            void ParseArray(EventHandler& handler) {
+                handler.StartArray();
 
-        template <>
-        void PrintValue<Array>(const Array& nodes, const PrintContext& ctx) {
-            std::ostream& out = ctx.out;
-            out << "[\n"sv;
-            bool first = true;
-            auto inner_ctx = ctx.Indented();
-            for (const Node& node : nodes) {
-                if (first) {
-                    first = false;
+                char c;
+                bool ok;
+                while ((ok = NextNonSpace(c)) && c != ']') {
+                    if (c != ',') {
+                        --pos_;
+                    }
+                    ParseNode(handler);
+                }
+                if (!ok) {
+                    throw ParsingError("Array parsing error"s);
+                }
+                handler.EndArray();
+            }
+
+            // Считывает ключ словаря вместе с последующим ':'
+            std::string_view LoadKey() {
+                const std::string_view key = ScanString();
+                if (char c = '"'; !NextNonSpace(c) || c != ':') {
+                    throw ParsingError(": is expected but '"s + c + "' has been found"s);
+                }
+                return key;
+            }
+
+            Node LoadDict() {
+                Dict dict(resource_);
+
+                char c;
+                bool ok;
+                while ((ok = NextNonSpace(c)) && c != '}') {
+                    if (c == '"') {
+                        std::string key(LoadKey());
+                        if (dict.find(key) != dict.end()) {
+                            throw ParsingError("Duplicate key '"s + key + "' have been found");
+                        }
+                        dict.emplace(std::move(key), LoadNode());
+                    } else if (c != ',') {
+                        throw ParsingError(R"(',' is expected but ')"s + c + "' has been found"s);
+                    }
+                }
+                if (!ok) {
+                    throw ParsingError("Dictionary parsing error"s);
+                }
+                return Node(std::move(dict));
+            }
+
+            void ParseDict(EventHandler& handler) {
+                handler.StartObject();
+
+                char c;
+                bool ok;
+                while ((ok = NextNonSpace(c)) && c != '}') {
+                    if (c == '"') {
+                        handler.Key(LoadKey());
+                        ParseNode(handler);
+                    } else if (c != ',') {
+                        throw ParsingError(R"(',' is expected but ')"s + c + "' has been found"s);
+                    }
+                }
+                if (!ok) {
+                    throw ParsingError("Dictionary parsing error"s);
+                }
+                handler.EndObject();
+            }
+
+            // Считывает строку после открывающей кавычки. Строка без escape-последовательностей
+            // возвращается как ссылка на входной буфер, иначе декодируется в scratch_.
+            // Результат действителен до следующего вызова ScanString
+            std::string_view ScanString() {
+                const char* begin = pos_;
+                bool in_scratch = false;
+                while (true) {
+                    const char* run = pos_;
+                    pos_ = FindStringSpecial(pos_);
+                    if (in_scratch) {
+                        scratch_.append(run, pos_);
+                    }
+
+                    if (pos_ == end_) {
+                        throw ParsingError("String parsing error");
+                    }
+                    const char ch = *pos_++;
+                    if (ch == '"') {
+                        break;
+                    } else if (ch == '\\') {
+                        if (!in_scratch) {
+                            scratch_.assign(begin, pos_ - 1);
+                            in_scratch = true;
+                        }
+                        if (pos_ == end_) {
+                            throw ParsingError("String parsing error");
+                        }
+                        const char escaped_char = *pos_++;
+                        switch (escaped_char) {
+                            case 'n':
+                                scratch_.push_back('\n');
+                                break;
+                            case 't':
+                                scratch_.push_back('\t');
+                                break;
+                            case 'r':
+                                scratch_.push_back('\r');
+                                break;
+                            case '"':
+                                scratch_.push_back('"');
+                                break;
+                            case '\\':
+                                scratch_.push_back('\\');
+                                break;
+                            default:
+                                throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
+                        }
+                    } else {
+                        throw ParsingError("Unexpected end of line"s);
+                    }
+                }
+                if (in_scratch) {
+                    return scratch_;
+                }
+                return {begin, static_cast<size_t>(pos_ - 1 - begin)};
+            }
+
+            // Ищет ближайший символ, прерывающий обычное содержимое строки: ", \, \n или \r
+            const char* FindStringSpecial(const char* p) {
+                if (!index_) {
+                    while (p != end_ && *p != '"' && *p != '\\' && *p != '\n' && *p != '\r') {
+                        ++p;
+                    }
+                    return p;
+                }
+                // Позиция разбора только растёт, поэтому курсор по индексу тоже движется вперёд
+                const auto offset = static_cast<uint32_t>(p - begin_);
+                const auto& index = *index_;
+                while (cursor_ < index.size() && index[cursor_] < offset) {
+                    ++cursor_;
+                }
+                for (; cursor_ < index.size(); ++cursor_) {
+                    const char ch = begin_[index[cursor_]];
+                    if (ch == '"' || ch == '\\' || ch == '\n' || ch == '\r') {
+                        return begin_ + index[cursor_];
+                    }
+                }
+                return end_;
+            }
+
+            bool LoadBool() {
+                const auto s = LoadLiteral();
+                if (s == "true"sv) {
+                    return true;
+                } else if (s == "false"sv) {
+                    return false;
                 } else {
-                    out << ",\n"sv;
+                    throw ParsingError("Failed to parse '"s + std::string(s) + "' as bool"s);
                 }
-                inner_ctx.PrintIndent();
-                PrintNode(node, inner_ctx);
             }
-            out.put('\n');
-            ctx.PrintIndent();
-            out.put(']');
-        }
 
-        template <>
-        void PrintValue<Dict>(const Dict& nodes, const PrintContext& ctx) {
-            std::ostream& out = ctx.out;
-            out << "{\n"sv;
-            bool first = true;
-            auto inner_ctx = ctx.Indented();
-            for (const auto& [key, node] : nodes) {
-                if (first) {
-                    first = false;
+            void LoadNull() {
+                if (auto literal = LoadLiteral(); literal != "null"sv) {
+                    throw ParsingError("Failed to parse '"s + std::string(literal) + "' as null"s);
+                }
+            }
+
+            Node LoadNumber() {
+                const char* begin = pos_;
+
+                auto peek = [this] {
+                    return pos_ != end_ ? *pos_ : '\0';
+                };
+
+                auto read_digits = [this, &peek] {
+                    if (!IsDigit(peek())) {
+                        throw ParsingError("A digit is expected"s);
+                    }
+                    while (IsDigit(peek())) {
+                        ++pos_;
+                    }
+                };
+
+                if (peek() == '-') {
+                    ++pos_;
+                }
+                if (peek() == '0') {
+                    ++pos_;
                 } else {
-                    out << ",\n"sv;
+                    read_digits();
+                }
+
+                bool is_int = true;
+                if (peek() == '.') {
+                    ++pos_;
+                    read_digits();
+                    is_int = false;
+                }
+
+                if (char ch = peek(); ch == 'e' || ch == 'E') {
+                    ++pos_;
+                    if (ch = peek(); ch == '+' || ch == '-') {
+                        ++pos_;
+                    }
+                    read_digits();
+                    is_int = false;
                 }
-                inner_ctx.PrintIndent();
-                PrintString(key, ctx.out);
-                out << ": "sv;
-                PrintNode(node, inner_ctx);
+
+                return ConvertNumber({begin, static_cast<size_t>(pos_ - begin)}, is_int);
             }
-            out.put('\n');
-            ctx.PrintIndent();
-            out.put('}');
-        }
 
-        void PrintNode(const Node& node, const PrintContext& ctx) {
-            std::visit(
-                    [&ctx](const auto& value) {
-                        PrintValue(value, ctx);
-                    },
-                    node.GetValue());
+            const char* begin_;
+            const char* pos_;
+            const char* end_;
+            const StructuralIndex* index_;
+            std::pmr::memory_resource* resource_;
+            size_t cursor_ = 0;
+            std::string scratch_;
+        };
+
+        // Разбирает буфер выбранным способом: для ScanMode::Structural сначала строится индекс
+        template <typename Action>
+        decltype(auto) WithParser(std::string_view input, ScanMode mode, std::pmr::memory_resource* resource,
+                                  Action action) {
+            if (mode == ScanMode::Structural && input.size() < std::numeric_limits<uint32_t>::max()) {
+                const StructuralIndex index = BuildStructuralIndex(input);
+                BufferParser parser(input, &index, resource);
+                return action(parser);
+            }
+            BufferParser parser(input, nullptr, resource);
+            return action(parser);
         }
 
     }  // namespace
@@ -347,8 +694,375 @@ namespace json {
         return Document{LoadNode(input)};
     }
 
-    void Print(const Document& doc, std::ostream& output) {
-        PrintNode(doc.GetRoot(), PrintContext{output});
+    Document Load(std::string_view input, const LoadOptions& options) {
+        auto load = [](BufferParser& parser) {
+            return parser.LoadNode();
+        };
+        if (!options.use_arena) {
+            return Document{WithParser(input, options.scan_mode, std::pmr::get_default_resource(), load)};
+        }
+        // Объём узлов примерно пропорционален размеру текста: первый блок арены
+        // берётся с запасом, остальные растут геометрически
+        auto arena = std::make_shared<std::pmr::monotonic_buffer_resource>(std::max<size_t>(input.size(), 4096));
+        Node root = WithParser(input, options.scan_mode, arena.get(), load);
+        return Document{std::move(root), std::move(arena)};
+    }
+
+    void Parse(std::string_view input, EventHandler& handler, ScanMode mode) {
+        WithParser(input, mode, std::pmr::get_default_resource(), [&handler](BufferParser& parser) {
+            parser.ParseNode(handler);
+        });
+    }
+
+    // ================= NodeBuilder =================
+
+    void NodeBuilder::StartObject() {
+        stack_.emplace_back(Dict{});
+        keys_.emplace_back();
+    }
+
+    void NodeBuilder::Key(std::string_view key) {
+        using namespace std::literals;
+        std::string& pending = keys_.back();
+        pending.assign(key);
+        if (stack_.back().AsDict().count(pending) > 0) {
+            throw ParsingError("Duplicate key '"s + pending + "' have been found");
+        }
+    }
+
+    void NodeBuilder::EndObject() {
+        keys_.pop_back();
+        Complete();
+    }
+
+    void NodeBuilder::StartArray() {
+        stack_.emplace_back(Array{});
+    }
+
+    void NodeBuilder::EndArray() {
+        Complete();
+    }
+
+    void NodeBuilder::String(std::string_view value) {
+        Place(Node(std::string(value)));
+    }
+
+    void NodeBuilder::Int(int value) {
+        Place(Node(value));
+    }
+
+    void NodeBuilder::Double(double value) {
+        Place(Node(value));
+    }
+
+    void NodeBuilder::Bool(bool value) {
+        Place(Node(value));
+    }
+
+    void NodeBuilder::Null() {
+        Place(Node(nullptr));
+    }
+
+    Node NodeBuilder::Extract() {
+        has_root_ = false;
+        return std::move(root_);
+    }
+
+    void NodeBuilder::Complete() {
+        Node container = std::move(stack_.back());
+        stack_.pop_back();
+        Place(std::move(container));
+    }
+
+    void NodeBuilder::Place(Node&& value) {
+        if (stack_.empty()) {
+            root_ = std::move(value);
+            has_root_ = true;
+        } else if (Node& top = stack_.back(); top.IsArray()) {
+            top.AsArray().push_back(std::move(value));
+        } else {
+            top.AsDict().emplace(std::move(keys_.back()), std::move(value));
+        }
+    }
+
+    // ================= Writer =================
+
+    using namespace std::literals;
+
+    Writer::Writer(std::ostream& out, PrintOptions options)
+            : out_(out), options_(options) {
+        buffer_.reserve(BUFFER_SIZE);
+    }
+
+    Writer::Writer(std::ostream& out, const Writer& parent)
+            : out_(out), options_(parent.options_), frames_(parent.frames_) {
+        if (frames_.empty() || frames_.back().is_dict) {
+            throw std::logic_error("Writer: the parent has no open array");
+        }
+        // Разделитель перед первым элементом выводит parent в AppendElements
+        frames_.back().first = true;
+        buffer_.reserve(BUFFER_SIZE);
+    }
+
+    Writer::~Writer() {
+        Flush();
+    }
+
+    void Writer::Flush() {
+        if (!buffer_.empty()) {
+            out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            bytes_written_ += buffer_.size();
+            buffer_.clear();
+        }
+    }
+
+    void Writer::Write(std::string_view text) {
+        if (buffer_.size() + text.size() > BUFFER_SIZE) {
+            Flush();
+            // Крупный фрагмент не копируется через буфер
+            if (text.size() >= BUFFER_SIZE) {
+                out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+                bytes_written_ += text.size();
+                return;
+            }
+        }
+        buffer_.append(text);
+    }
+
+    void Writer::Put(char c) {
+        if (buffer_.size() >= BUFFER_SIZE) {
+            Flush();
+        }
+        buffer_.push_back(c);
+    }
+
+    void Writer::WriteIndent(size_t depth) {
+        size_t count = depth * static_cast<size_t>(options_.indent_step);
+        while (count > 0) {
+            static constexpr std::string_view spaces = "                                ";
+            const size_t chunk = std::min(count, spaces.size());
+            Write(spaces.substr(0, chunk));
+            count -= chunk;
+        }
+    }
+
+    void Writer::BeforeValue() {
+        if (frames_.empty()) {
+            return;
+        }
+        Frame& top = frames_.back();
+        if (top.is_dict) {
+            // Разделитель и отступ уже выведены вместе с ключом
+            return;
+        }
+        if (!top.first) {
+            Write(options_.compact ? ","sv : ",\n"sv);
+        }
+        top.first = false;
+        if (!options_.compact) {
+            WriteIndent(frames_.size());
+        }
+    }
+
+    void Writer::OpenContainer(char bracket, bool is_dict) {
+        BeforeValue();
+        Put(bracket);
+        if (!options_.compact) {
+            Put('\n');
+        }
+        frames_.push_back(Frame{is_dict, true});
+    }
+
+    void Writer::CloseContainer(char bracket) {
+        frames_.pop_back();
+        if (!options_.compact) {
+            Put('\n');
+            WriteIndent(frames_.size());
+        }
+        Put(bracket);
+    }
+
+    void Writer::StartArray() {
+        OpenContainer('[', false);
+    }
+
+    void Writer::EndArray() {
+        CloseContainer(']');
+    }
+
+    void Writer::StartDict() {
+        OpenContainer('{', true);
+    }
+
+    void Writer::EndDict() {
+        CloseContainer('}');
+    }
+
+    void Writer::AppendElements(std::string_view text) {
+        if (text.empty()) {
+            return;
+        }
+        // Отступ первого элемента уже есть в тексте, не хватает только разделителя
+        Frame& top = frames_.back();
+        if (!top.first) {
+            Write(options_.compact ? ","sv : ",\n"sv);
+        }
+        top.first = false;
+        Write(text);
+    }
+
+    void Writer::Key(std::string_view key) {
+        Frame& top = frames_.back();
+        if (!top.first) {
+            Write(options_.compact ? ","sv : ",\n"sv);
+        }
+        top.first = false;
+        if (!options_.compact) {
+            WriteIndent(frames_.size());
+        }
+        WriteEscaped(key);
+        Write(options_.compact ? ":"sv : ": "sv);
+    }
+
+    void Writer::WriteEscaped(std::string_view text) {
+        Put('"');
+        WriteEscapedChars(text);
+        Put('"');
+    }
+
+    void Writer::WriteEscapedChars(std::string_view text) {
+        const char* run = text.data();
+        const char* const end = run + text.size();
+        for (const char* p = run; p != end; ++p) {
+            std::string_view escaped;
+            switch (*p) {
+                case '\r':
+                    escaped = "\\r"sv;
+                    break;
+                case '\n':
+                    escaped = "\\n"sv;
+                    break;
+                case '\t':
+                    escaped = "\\t"sv;
+                    break;
+                case '"':
+                    escaped = "\\\""sv;
+                    break;
+                case '\\':
+                    escaped = "\\\\"sv;
+                    break;
+                default:
+                    continue;
+            }
+            // Символы без экранирования выводятся одним блоком
+            Write({run, static_cast<size_t>(p - run)});
+            Write(escaped);
+            run = p + 1;
+        }
+        Write({run, static_cast<size_t>(end - run)});
+    }
+
+    void Writer::Value(std::string_view value) {
+        BeforeValue();
+        WriteEscaped(value);
+    }
+
+    void Writer::Value(const char* value) {
+        Value(std::string_view(value));
+    }
+
+    void Writer::Value(const std::string& value) {
+        Value(std::string_view(value));
+    }
+
+    void Writer::Value(int value) {
+        BeforeValue();
+        WriteNumber(value);
+    }
+
+    void Writer::Value(double value) {
+        BeforeValue();
+        WriteNumber(value);
+    }
+
+    void Writer::Value(bool value) {
+        BeforeValue();
+        Write(value ? "true"sv : "false"sv);
+    }
+
+    void Writer::Value(std::nullptr_t) {
+        BeforeValue();
+        Write("null"sv);
+    }
+
+    // Поток без собственного буфера: всё, что в него пишут, сразу экранируется в буфер писателя
+    class Writer::EscapingBuffer : public std::streambuf {
+    public:
+        explicit EscapingBuffer(Writer& writer) : writer_(writer) {}
+
+    protected:
+        std::streamsize xsputn(const char* text, std::streamsize size) override {
+            writer_.WriteEscapedChars({text, static_cast<size_t>(size)});
+            return size;
+        }
+
+        int_type overflow(int_type c) override {
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                const char ch = traits_type::to_char_type(c);
+                writer_.WriteEscapedChars({&ch, 1});
+            }
+            return traits_type::not_eof(c);
+        }
+
+    private:
+        Writer& writer_;
+    };
+
+    void Writer::Value(const StreamedString& value) {
+        BeforeValue();
+        Put('"');
+        EscapingBuffer buffer(*this);
+        std::ostream out(&buffer);
+        // Иначе ошибка вывода осталась бы только флагом потока
+        out.exceptions(std::ios::badbit);
+        value.write(out);
+        Put('"');
+    }
+
+    // Числа выводятся через std::to_chars: double — в кратчайшей записи,
+    // которая читается обратно в то же самое значение
+    template <typename Number>
+    void Writer::WriteNumber(Number value) {
+        char buf[32];
+        const auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        Write({buf, static_cast<size_t>(ptr - buf)});
+    }
+
+    void Writer::WriteNode(const Node& node) {
+        std::visit([this](const auto& value) {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_same_v<T, Array>) {
+                StartArray();
+                for (const Node& item : value) {
+                    WriteNode(item);
+                }
+                EndArray();
+            } else if constexpr (std::is_same_v<T, Dict>) {
+                StartDict();
+                for (const auto& [key, item] : value) {
+                    Key(key);
+                    WriteNode(item);
+                }
+                EndDict();
+            } else {
+                Value(value);
+            }
+        }, node.GetValue());
+    }
+
+    void Print(const Document& doc, std::ostream& output, const PrintOptions& options) {
+        Writer writer(output, options);
+        writer.WriteNode(doc.GetRoot());
     }
 
 }  // namespace json
\ No newline at end of file
@@ -203,3 +203,115 @@ namespace json {
         return ArrayContext(b_);
     }
 } // namespace json
+
+namespace json {
+
+    TextBuilder::DictContext TextBuilder::StartDict() {
+        PushContainer(true);
+        return DictContext(*this);
+    }
+
+    TextBuilder::ArrayContext TextBuilder::StartArray() {
+        PushContainer(false);
+        return ArrayContext(*this);
+    }
+
+    TextBuilder::KeyContext TextBuilder::Key(std::string_view key) {
+        EnsureNotReady("Key()");
+        EnsureInDictForKey("Key()");
+        writer_.Key(key);
+        pending_key_ = true;
+        return KeyContext(*this);
+    }
+
+    void TextBuilder::Build() const {
+        if (!has_root_) {
+            throw std::logic_error("Build(): объект не задан");
+        }
+        if (depth_ != 0) {
+            throw std::logic_error("Build(): есть незакрытые контейнеры");
+        }
+    }
+
+    void TextBuilder::EnsureNotReady(const char* where) const {
+        if (Ready()) {
+            throw std::logic_error(std::string(where) + ": объект уже построен");
+        }
+    }
+
+    void TextBuilder::EnsureCanPlaceValue(const char* where) const {
+        if (depth_ == 0 || !InDict() || pending_key_) {
+            return;
+        }
+        throw std::logic_error(std::string(where) + ": значение допустимо только после конструктора, после Key() или внутри массива");
+    }
+
+    void TextBuilder::EnsureInDictForKey(const char* where) const {
+        if (!InDict()) {
+            throw std::logic_error(std::string(where) + ": Key() допустим только внутри словаря");
+        }
+        if (pending_key_) {
+            throw std::logic_error(std::string(where) + ": предыдущий Key() ещё не получил значение");
+        }
+    }
+
+    void TextBuilder::PushContainer(bool is_dict) {
+        const char* where = is_dict ? "StartDict()" : "StartArray()";
+        EnsureNotReady(where);
+        EnsureCanPlaceValue(where);
+        if (depth_ == MAX_DEPTH) {
+            throw std::logic_error(std::string(where) + ": слишком глубокая вложенность");
+        }
+        if (is_dict) {
+            dict_mask_ |= uint64_t{1} << depth_;
+            writer_.StartDict();
+        } else {
+            dict_mask_ &= ~(uint64_t{1} << depth_);
+            writer_.StartArray();
+        }
+        ++depth_;
+        has_root_ = true;
+        pending_key_ = false;
+    }
+
+    void TextBuilder::PopContainer(bool is_dict, const char* where) {
+        EnsureNotReady(where);
+        if (depth_ == 0 || InDict() != is_dict) {
+            throw std::logic_error(std::string(where) + (is_dict ? ": текущий контекст не словарь" : ": текущий контекст не массив"));
+        }
+        if (pending_key_) {
+            throw std::logic_error(std::string(where) + ": для последнего Key() не задано значение");
+        }
+        --depth_;
+        if (is_dict) {
+            writer_.EndDict();
+        } else {
+            writer_.EndArray();
+        }
+    }
+
+    // ================= BaseContext =================
+
+    TextBuilder::KeyContext TextBuilder::BaseContext::Key(std::string_view key) {
+        return b_.Key(key);
+    }
+
+    TextBuilder::DictContext TextBuilder::BaseContext::StartDict() {
+        return b_.StartDict();
+    }
+
+    TextBuilder::ArrayContext TextBuilder::BaseContext::StartArray() {
+        return b_.StartArray();
+    }
+
+    TextBuilder::BaseContext TextBuilder::BaseContext::EndDict() {
+        b_.PopContainer(true, "EndDict()");
+        return BaseContext(b_);
+    }
+
+    TextBuilder::BaseContext TextBuilder::BaseContext::EndArray() {
+        b_.PopContainer(false, "EndArray()");
+        return BaseContext(b_);
+    }
+
+} // namespace json
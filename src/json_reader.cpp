@@ -4,35 +4,224 @@
 #include "json_builder.h"
 
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <algorithm>
+#include <limits>
 #include <sstream>
+#include <type_traits>
+#include <vector>
+#include <variant>
 
 // Constants for JSON keys
 constexpr const char* BASE_REQUESTS_KEY = "base_requests";
 constexpr const char* STAT_REQUESTS_KEY = "stat_requests";
 constexpr const char* RENDER_SETTINGS_KEY = "render_settings";
+constexpr const char* ROUTING_SETTINGS_KEY = "routing_settings";
 
 constexpr const char* ID_KEY = "id";
 constexpr const char* TYPE_KEY = "type";
 constexpr const char* NAME_KEY = "name";
 constexpr const char* LATITUDE_KEY = "latitude";
 constexpr const char* LONGITUDE_KEY = "longitude";
+constexpr const char* RADIUS_KEY = "radius";
+constexpr const char* COUNT_KEY = "count";
+constexpr const char* FROM_KEY = "from";
+constexpr const char* TO_KEY = "to";
 
 constexpr const char* STOP_TYPE = "Stop";
 constexpr const char* BUS_TYPE = "Bus";
 constexpr const char* MAP_TYPE = "Map";
+constexpr const char* NEARBY_STOPS_TYPE = "NearbyStops";
+constexpr const char* ROUTE_TYPE = "Route";
+
+// Parallel streaming mode: requests per pool thread answered before they are written out,
+// and requests whose answers one task writes together
+constexpr size_t STAT_WINDOW_PER_THREAD = 256;
+constexpr size_t STAT_BLOCK_SIZE = 32;
 
 namespace transport_catalogue {
 
+    namespace {
+
+        json::ParsingError NotAnArray(std::string_view key) {
+            return json::ParsingError(std::string(key) + " is not an array");
+        }
+
+    } // namespace
+
     JsonReader::JsonReader(json::Document input_doc,
                            TransportCatalogue& db)
-        : db_(db), input_doc_(std::move(input_doc)) {
-        ReadInput();
+        : db_(db) {
+        ReadInput(input_doc.GetRoot());
+    }
+
+    // Routes parser events of the root object: every element of base_requests and
+    // stat_requests is assembled into its own small Node, handed to the reader and
+    // dropped; render_settings is kept as is; everything else is skipped
+    class JsonReader::StreamHandler final : public json::EventHandler {
+    public:
+        explicit StreamHandler(JsonReader& reader) : reader_(reader) {}
+
+        void StartObject() override {
+            if (depth_ == 0) {
+                ++depth_;
+                return;
+            }
+            CheckNotRequests();
+            Enter();
+            Forward([](json::EventHandler& h) { h.StartObject(); });
+        }
+
+        void Key(std::string_view key) override {
+            if (depth_ == 1) {
+                using namespace std::literals;
+                if (!root_keys_.emplace(key).second) {
+                    throw json::ParsingError("Duplicate key '"s + std::string(key) + "' have been found");
+                }
+                section_ = key == BASE_REQUESTS_KEY   ? Section::BaseRequests
+                         : key == STAT_REQUESTS_KEY   ? Section::StatRequests
+                         : key == RENDER_SETTINGS_KEY ? Section::RenderSettings
+                         : key == ROUTING_SETTINGS_KEY ? Section::RoutingSettings
+                                                      : Section::Other;
+                return;
+            }
+            Forward([key](json::EventHandler& h) { h.Key(key); });
+        }
+
+        void EndObject() override {
+            if (depth_ == 1) {
+                depth_ = 0;
+                return;
+            }
+            Forward([](json::EventHandler& h) { h.EndObject(); });
+            Leave();
+        }
+
+        void StartArray() override {
+            if (depth_ == 0) {
+                throw std::logic_error("Not a dict");
+            }
+            if (depth_ == 1 && (section_ == Section::BaseRequests || section_ == Section::StatRequests)) {
+                ++depth_;
+                in_requests_ = true;
+                return;
+            }
+            Enter();
+            Forward([](json::EventHandler& h) { h.StartArray(); });
+        }
+
+        void EndArray() override {
+            if (depth_ == 2 && in_requests_) {
+                --depth_;
+                in_requests_ = false;
+                return;
+            }
+            Forward([](json::EventHandler& h) { h.EndArray(); });
+            Leave();
+        }
+
+        void String(std::string_view value) override {
+            Scalar([value](json::EventHandler& h) { h.String(value); });
+        }
+
+        void Int(int value) override {
+            Scalar([value](json::EventHandler& h) { h.Int(value); });
+        }
+
+        void Double(double value) override {
+            Scalar([value](json::EventHandler& h) { h.Double(value); });
+        }
+
+        void Bool(bool value) override {
+            Scalar([value](json::EventHandler& h) { h.Bool(value); });
+        }
+
+        void Null() override {
+            Scalar([](json::EventHandler& h) { h.Null(); });
+        }
+
+    private:
+        enum class Section { Other, BaseRequests, StatRequests, RenderSettings, RoutingSettings };
+
+        // A value is collected when it is an element of a request array or one of the settings
+        [[nodiscard]] bool Collecting() const {
+            return in_requests_ || section_ == Section::RenderSettings || section_ == Section::RoutingSettings;
+        }
+
+        // base_requests and stat_requests must hold arrays, like in the document mode
+        void CheckNotRequests() const {
+            if (depth_ == 1 && section_ == Section::BaseRequests) {
+                throw NotAnArray(BASE_REQUESTS_KEY);
+            }
+            if (depth_ == 1 && section_ == Section::StatRequests) {
+                throw NotAnArray(STAT_REQUESTS_KEY);
+            }
+        }
+
+        void Enter() {
+            ++depth_;
+        }
+
+        void Leave() {
+            --depth_;
+            Flush();
+        }
+
+        template <typename Event>
+        void Forward(Event event) {
+            if (Collecting()) {
+                event(builder_);
+            }
+        }
+
+        template <typename Event>
+        void Scalar(Event event) {
+            if (depth_ == 0) {
+                throw std::logic_error("Not a dict");
+            }
+            CheckNotRequests();
+            Forward(event);
+            Flush();
+        }
+
+        // Hands a completed value over to the reader
+        void Flush() {
+            if (!builder_.HasValue()) {
+                return;
+            }
+            json::Node value = builder_.Extract();
+            if (in_requests_) {
+                if (section_ == Section::BaseRequests) {
+                    reader_.ParseBaseRequest(value);
+                } else {
+                    reader_.ParseStatRequest(value);
+                }
+            } else if (section_ == Section::RenderSettings) {
+                reader_.render_settings_ = std::move(value);
+            } else if (section_ == Section::RoutingSettings) {
+                reader_.routing_settings_ = std::move(value);
+            }
+        }
+
+        JsonReader& reader_;
+        json::NodeBuilder builder_;
+        std::unordered_set<std::string> root_keys_;
+        Section section_ = Section::Other;
+        bool in_requests_ = false;
+        int depth_ = 0;
+    };
+
+    JsonReader::JsonReader(std::string_view input,
+                           TransportCatalogue& db,
+                           json::ScanMode scan_mode)
+        : db_(db) {
+        StreamHandler handler(*this);
+        json::Parse(input, handler, scan_mode);
     }
 
     static const json::Node* TryGet(const json::Dict& d, std::string_view k) {
-        auto it = d.find(std::string(k));
+        auto it = d.find(k);
         return it == d.end() ? nullptr : &it->second;
     }
 
@@ -54,14 +243,26 @@ namespace transport_catalogue {
         );
     }
 
-    void JsonReader::ReadInput() {
-        const auto& root = input_doc_.GetRoot().AsDict();
-        if (auto it = root.find(BASE_REQUESTS_KEY); it != root.end() && it->second.IsArray()) {
+    void JsonReader::ReadInput(const json::Node& root_node) {
+        const auto& root = root_node.AsDict();
+        if (auto it = root.find(BASE_REQUESTS_KEY); it != root.end()) {
+            if (!it->second.IsArray()) {
+                throw NotAnArray(BASE_REQUESTS_KEY);
+            }
             ParseBaseRequests(it->second.AsArray());
         }
-        if (auto it = root.find(STAT_REQUESTS_KEY); it != root.end() && it->second.IsArray()) {
+        if (auto it = root.find(STAT_REQUESTS_KEY); it != root.end()) {
+            if (!it->second.IsArray()) {
+                throw NotAnArray(STAT_REQUESTS_KEY);
+            }
             ParseStatRequests(it->second.AsArray());
         }
+        if (auto it = root.find(RENDER_SETTINGS_KEY); it != root.end()) {
+            render_settings_ = it->second;
+        }
+        if (auto it = root.find(ROUTING_SETTINGS_KEY); it != root.end()) {
+            routing_settings_ = it->second;
+        }
     }
 
     void JsonReader::ProcessBaseRequests() {
@@ -87,90 +288,221 @@ namespace transport_catalogue {
             }
             db_.AddBus(b.name, stops_ptrs, b.is_roundtrip);
         }
+
+        // Base requests come all at once, the catalogue is only read afterwards
+        db_.Freeze();
     }
 
-    json::Array JsonReader::ProcessStatRequests(const RequestHandler& handler) const {
+    json::Array JsonReader::ProcessStatRequests(const RequestHandler& handler, ThreadPool* pool) const {
         json::Array responses;
+        if (pool) {
+            // The catalogue is frozen and the handler is const, so requests can run side by side
+            responses.resize(stat_requests_.size());
+            pool->ParallelFor(stat_requests_.size(), [&](size_t i) {
+                responses[i] = ProcessStatRequest(stat_requests_[i], handler);
+            });
+            return responses;
+        }
+
         responses.reserve(stat_requests_.size());
 
         for (const auto& req : stat_requests_) {
-            json::Node response_node;
-
-            if (req.type == BUS_TYPE) {
-                auto bus_info = handler.GetBusInfo(req.name);
-                if (bus_info) {
-                    response_node = json::Builder{}
-                            .StartDict()
-                                .Key("request_id").Value(req.id)
-                                .Key("curvature").Value(bus_info->curvature)
-                                .Key("route_length").Value(bus_info->route_length)
-                                .Key("stop_count").Value(static_cast<int>(bus_info->stops_count))
-                                .Key("unique_stop_count").Value(static_cast<int>(bus_info->unique_stops_count))
-                            .EndDict()
-                            .Build();
-                } else {
-                    response_node = json::Builder{}
-                            .StartDict()
-                                .Key("request_id").Value(req.id)
-                                .Key("error_message").Value("not found")
-                            .EndDict()
-                            .Build().AsDict();
+            responses.push_back(ProcessStatRequest(req, handler));
+        }
+
+        return responses;
+    }
+
+    void JsonReader::ProcessStatRequests(const RequestHandler& handler, json::Writer& writer,
+                                         ThreadPool* pool) const {
+        writer.StartArray();
+        if (pool) {
+            // Workers write blocks of answers as text for a window of requests, then the blocks
+            // are appended in order; only a window is held in memory however long the batch is.
+            // A Map answer is written here instead: the renderer can use the whole pool for it,
+            // and the map goes straight out rather than into a block
+            const size_t window_size = pool->GetThreadCount() * STAT_WINDOW_PER_THREAD;
+            std::vector<std::string> blocks((window_size + STAT_BLOCK_SIZE - 1) / STAT_BLOCK_SIZE);
+            for (size_t begin = 0, end; begin < stat_requests_.size(); begin = end) {
+                if (stat_requests_[begin].type == MAP_TYPE) {
+                    json::TextBuilder builder(writer);
+                    BuildStatResponse(builder, stat_requests_[begin], handler);
+                    builder.Build();
+                    writer.Flush();
+                    end = begin + 1;
+                    continue;
                 }
-            } else if (req.type == STOP_TYPE) {
-                json::Array buses_json;
-                auto buses = handler.GetBusesByStop(req.name);
-                if (!buses) {
-                    response_node = json::Builder{}
-                            .StartDict()
-                                .Key("request_id").Value(req.id)
-                                .Key("error_message").Value("not found")
-                            .EndDict()
-                            .Build();
-                } else {
-                    std::vector<std::string> names;
-                    names.reserve(buses->size());
-                    for (const auto* bus : *buses) {
-                        names.emplace_back(bus->name);
+                end = begin + 1;
+                while (end < std::min(begin + window_size, stat_requests_.size())
+                       && stat_requests_[end].type != MAP_TYPE) {
+                    ++end;
+                }
+                const size_t block_count = (end - begin + STAT_BLOCK_SIZE - 1) / STAT_BLOCK_SIZE;
+                pool->ParallelFor(block_count, [&](size_t block) {
+                    std::ostringstream out;
+                    {
+                        json::Writer block_writer(out, writer);
+                        const size_t first = begin + block * STAT_BLOCK_SIZE;
+                        for (size_t i = first; i < std::min(first + STAT_BLOCK_SIZE, end); ++i) {
+                            json::TextBuilder builder(block_writer);
+                            BuildStatResponse(builder, stat_requests_[i], handler);
+                            builder.Build();
+                        }
                     }
-                    std::sort(names.begin(), names.end());
-                    names.erase(std::unique(names.begin(), names.end()), names.end());
+                    blocks[block] = std::move(out).str();
+                });
+                for (size_t block = 0; block < block_count; ++block) {
+                    writer.AppendElements(blocks[block]);
+                }
+                writer.Flush();
+            }
+            writer.EndArray();
+            writer.Flush();
+            return;
+        }
 
-                    buses_json.reserve(names.size());
-                    for (const auto& name : names) {
-                        buses_json.emplace_back(name);
-                    }
+        for (const auto& req : stat_requests_) {
+            json::TextBuilder builder(writer);
+            BuildStatResponse(builder, req, handler);
+            builder.Build();
+            // Send every answer on right away instead of holding it until the batch ends
+            writer.Flush();
+        }
+        writer.EndArray();
+        writer.Flush();
+    }
 
-                    response_node = json::Builder{}
-                            .StartDict()
-                                .Key("request_id").Value(req.id)
-                                .Key("buses").Value(std::move(buses_json))
-                            .EndDict()
-                            .Build();
-                }
-            } else if (req.type == MAP_TYPE) {
-                std::ostringstream svg_buf;
-                handler.RenderMap().Render(svg_buf);
+    json::Node JsonReader::ProcessStatRequest(const StatRequest& req, const RequestHandler& handler) const {
+        json::Builder builder;
+        BuildStatResponse(builder, req, handler);
+        return builder.Build();
+    }
+
+    // Text answers get the map streamed straight into the output, escaped on the way;
+    // Node trees need the SVG text as a string
+    template <typename ResponseBuilder>
+    static auto MapValue(const RequestHandler& handler) {
+        if constexpr (std::is_same_v<ResponseBuilder, json::TextBuilder>) {
+            return json::StreamedString{[&handler](std::ostream& out) { handler.RenderMapSvg(out); }};
+        } else {
+            std::ostringstream out;
+            handler.RenderMapSvg(out);
+            return std::move(out).str();
+        }
+    }
 
-                response_node = json::Builder{}
-                        .StartDict()
+    // Shared by json::Builder (answers as Node trees) and json::TextBuilder (answers
+    // written straight to the output): both expose the same context API.
+    // Keys go in ascending order so the text matches a printed json::Dict byte for byte
+    template <typename ResponseBuilder>
+    void JsonReader::BuildStatResponse(ResponseBuilder& builder, const StatRequest& req,
+                                       const RequestHandler& handler) const {
+        if (req.type == BUS_TYPE) {
+            auto bus_info = handler.GetBusInfo(req.name);
+            if (bus_info) {
+                builder.StartDict()
+                            .Key("curvature").Value(bus_info->curvature)
                             .Key("request_id").Value(req.id)
-                            .Key("map").Value(svg_buf.str())
-                        .EndDict()
-                        .Build();
+                            .Key("route_length").Value(bus_info->route_length)
+                            .Key("stop_count").Value(static_cast<int>(bus_info->stops_count))
+                            .Key("unique_stop_count").Value(static_cast<int>(bus_info->unique_stops_count))
+                        .EndDict();
+            } else {
+                builder.StartDict()
+                            .Key("error_message").Value("not found")
+                            .Key("request_id").Value(req.id)
+                        .EndDict();
             }
-
-            responses.push_back(std::move(response_node));
+        } else if (req.type == STOP_TYPE) {
+            auto buses = handler.GetBusesByStop(req.name);
+            if (!buses) {
+                builder.StartDict()
+                            .Key("error_message").Value("not found")
+                            .Key("request_id").Value(req.id)
+                        .EndDict();
+            } else {
+                auto buses_json = builder.StartDict()
+                                            .Key("buses").StartArray();
+                for (const Bus* bus : *buses) {
+                    buses_json.Value(bus->name);
+                }
+                buses_json.EndArray()
+                            .Key("request_id").Value(req.id)
+                        .EndDict();
+            }
+        } else if (req.type == NEARBY_STOPS_TYPE) {
+            // A request without a center or with a negative (or NaN) radius has no answer
+            if (!req.center || (req.radius && !(*req.radius >= 0))) {
+                builder.StartDict()
+                            .Key("error_message").Value("not found")
+                            .Key("request_id").Value(req.id)
+                        .EndDict();
+                return;
+            }
+            // With neither a radius nor a count the request would ask for the whole catalogue
+            std::vector<StopDistance> stops;
+            if (req.radius || req.count) {
+                stops = handler.GetNearbyStops(*req.center,
+                                               req.radius.value_or(std::numeric_limits<double>::infinity()),
+                                               req.count.value_or(std::numeric_limits<size_t>::max()));
+            }
+            auto stops_json = builder.StartDict()
+                                        .Key("request_id").Value(req.id)
+                                        .Key("stops").StartArray();
+            for (const auto& [stop, distance] : stops) {
+                stops_json.StartDict()
+                            .Key("distance").Value(distance)
+                            .Key("name").Value(stop->name)
+                        .EndDict();
+            }
+            stops_json.EndArray()
+                    .EndDict();
+        } else if (req.type == ROUTE_TYPE) {
+            auto route = handler.BuildRoute(req.from, req.to);
+            if (!route) {
+                builder.StartDict()
+                            .Key("error_message").Value("not found")
+                            .Key("request_id").Value(req.id)
+                        .EndDict();
+            } else {
+                auto items_json = builder.StartDict()
+                                            .Key("items").StartArray();
+                for (const auto& item : route->items) {
+                    if (const auto* wait = std::get_if<router::WaitItem>(&item)) {
+                        items_json.StartDict()
+                                    .Key("stop_name").Value(wait->stop->name)
+                                    .Key("time").Value(wait->time)
+                                    .Key("type").Value("Wait")
+                                .EndDict();
+                    } else {
+                        const auto& ride = std::get<router::BusItem>(item);
+                        items_json.StartDict()
+                                    .Key("bus").Value(ride.bus->name)
+                                    .Key("span_count").Value(ride.span_count)
+                                    .Key("time").Value(ride.time)
+                                    .Key("type").Value("Bus")
+                                .EndDict();
+                    }
+                }
+                items_json.EndArray()
+                            .Key("request_id").Value(req.id)
+                            .Key("total_time").Value(route->total_time)
+                        .EndDict();
+            }
+        } else if (req.type == MAP_TYPE) {
+            builder.StartDict()
+                        .Key("map").Value(MapValue<ResponseBuilder>(handler))
+                        .Key("request_id").Value(req.id)
+                    .EndDict();
+        } else {
+            builder.Value(nullptr);
         }
-
-        return responses;
     }
 
     void JsonReader::ProcessRenderSettings(renderer::MapRenderer& renderer) {
-        const auto& root = input_doc_.GetRoot().AsDict();
-        auto it_rs = root.find(RENDER_SETTINGS_KEY);
-        if (it_rs == root.end()) return; // nothing to render
+        if (render_settings_.IsNull()) return; // nothing to render
 
-        const auto& rs = it_rs->second.AsDict();
+        const auto& rs = render_settings_.AsDict();
         renderer::RenderSettings s{};   // have sensible defaults in this struct
 
         if (auto p = TryGet(rs, "width")) {
@@ -221,41 +553,84 @@ namespace transport_catalogue {
         renderer.SetSettings(std::move(s));
     }
 
+    std::optional<router::RoutingSettings> JsonReader::GetRoutingSettings() const {
+        if (!routing_settings_.IsDict()) {
+            return std::nullopt;
+        }
+        const auto& rs = routing_settings_.AsDict();
+        router::RoutingSettings s{};
+        if (auto p = TryGet(rs, "bus_wait_time")) {
+            s.bus_wait_time = p->AsDouble();
+        }
+        if (auto p = TryGet(rs, "bus_velocity")) {
+            s.bus_velocity = p->AsDouble();
+        }
+        return s;
+    }
+
     void JsonReader::ParseBaseRequests(const json::Array& reqs) {
         for (const auto& node : reqs) {
-            if (!node.IsDict()) continue;
-            const auto& m = node.AsDict();
-
-            const auto* type_n = TryGet(m, TYPE_KEY);
-            if (!type_n || !type_n->IsString()) continue;
-            const std::string type = type_n->AsString();
-
-            if (type == STOP_TYPE) {
-                ParseStopRequests(m);
-            } else if (type == BUS_TYPE) {
-                ParseBusRequests(m);
-            }
+            ParseBaseRequest(node);
         }
     }
 
     void JsonReader::ParseStatRequests(const json::Array& reqs) {
         for (const auto& node : reqs) {
-            if (!node.IsDict()) continue;
-            const auto& m = node.AsDict();
+            ParseStatRequest(node);
+        }
+    }
+
+    void JsonReader::ParseBaseRequest(const json::Node& node) {
+        if (!node.IsDict()) return;
+        const auto& m = node.AsDict();
+
+        const auto* type_n = TryGet(m, TYPE_KEY);
+        if (!type_n || !type_n->IsString()) return;
+        const std::string type = type_n->AsString();
+
+        if (type == STOP_TYPE) {
+            ParseStopRequests(m);
+        } else if (type == BUS_TYPE) {
+            ParseBusRequests(m);
+        }
+    }
+
+    void JsonReader::ParseStatRequest(const json::Node& node) {
+        if (!node.IsDict()) return;
+        const auto& m = node.AsDict();
 
-            StatRequest stat_request;
-            if (const auto* type_n = TryGet(m, TYPE_KEY); type_n && type_n->IsString()) {
-                stat_request.type = type_n->AsString();
+        StatRequest stat_request;
+        if (const auto* type_n = TryGet(m, TYPE_KEY); type_n && type_n->IsString()) {
+            stat_request.type = type_n->AsString();
+        }
+        if (const auto* name_n = TryGet(m, NAME_KEY); name_n && name_n->IsString()) {
+            stat_request.name = name_n->AsString();
+        }
+        if (const auto* id_n = TryGet(m, ID_KEY); id_n && id_n->IsInt()) {
+            stat_request.id = id_n->AsInt();
+        }
+        if (stat_request.type == ROUTE_TYPE) {
+            if (const auto* from_n = TryGet(m, FROM_KEY); from_n && from_n->IsString()) {
+                stat_request.from = from_n->AsString();
             }
-            if (const auto* name_n = TryGet(m, NAME_KEY); name_n && name_n->IsString()) {
-                stat_request.name = name_n->AsString();
+            if (const auto* to_n = TryGet(m, TO_KEY); to_n && to_n->IsString()) {
+                stat_request.to = to_n->AsString();
             }
-            if (const auto* id_n = TryGet(m, ID_KEY); id_n && id_n->IsInt()) {
-                stat_request.id = id_n->AsInt();
+        } else if (stat_request.type == NEARBY_STOPS_TYPE) {
+            const auto* lat_n = TryGet(m, LATITUDE_KEY);
+            const auto* lng_n = TryGet(m, LONGITUDE_KEY);
+            if (lat_n && lng_n && lat_n->IsDouble() && lng_n->IsDouble()) {
+                stat_request.center = geo::Coordinates{lat_n->AsDouble(), lng_n->AsDouble()};
+            }
+            if (const auto* radius_n = TryGet(m, RADIUS_KEY); radius_n && radius_n->IsDouble()) {
+                stat_request.radius = radius_n->AsDouble();
+            }
+            if (const auto* count_n = TryGet(m, COUNT_KEY); count_n && count_n->IsInt() && count_n->AsInt() >= 0) {
+                stat_request.count = static_cast<size_t>(count_n->AsInt());
             }
-
-            stat_requests_.push_back(std::move(stat_request));
         }
+
+        stat_requests_.push_back(std::move(stat_request));
     }
 
     void JsonReader::ParseStopRequests(const json::Dict& dict) {
@@ -0,0 +1,261 @@
+#include "landmarks.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace graph {
+
+    namespace {
+
+        constexpr double INF = std::numeric_limits<double>::infinity();
+        constexpr EdgeId NO_EDGE = static_cast<EdgeId>(-1);
+
+        // Distances from source to every vertex, infinity for those it cannot reach
+        std::vector<double> ShortestDistances(const DirectedWeightedGraph<double>& graph, VertexId source) {
+            std::vector<double> distance(graph.GetVertexCount(), INF);
+            std::vector<std::pair<double, VertexId>> heap;
+            const auto by_distance = std::greater<>{};
+            distance[source] = 0.0;
+            heap.emplace_back(0.0, source);
+            while (!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), by_distance);
+                const auto [d, vertex] = heap.back();
+                heap.pop_back();
+                if (d > distance[vertex]) {
+                    continue;
+                }
+                for (const auto& edge : graph.GetIncidentEdges(vertex)) {
+                    if (d + edge.weight < distance[edge.to]) {
+                        distance[edge.to] = d + edge.weight;
+                        heap.emplace_back(distance[edge.to], edge.to);
+                        std::push_heap(heap.begin(), heap.end(), by_distance);
+                    }
+                }
+            }
+            return distance;
+        }
+
+        uint64_t Mix(uint64_t hash, uint64_t value) {
+            hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+            return hash * 0xff51afd7ed558ccdULL;
+        }
+
+    } // namespace
+
+    Landmarks::Landmarks(const DirectedWeightedGraph<double>& graph, size_t count) : graph_hash_(HashGraph(graph)) {
+        const size_t vertex_count = graph.GetVertexCount();
+        if (count == 0 && vertex_count > 0) {
+            throw std::invalid_argument("Landmarks: at least one landmark is needed");
+        }
+        std::vector<Edge<double>> reversed;
+        reversed.reserve(graph.GetEdgeCount());
+        std::vector<bool> has_edges(vertex_count, false);
+        for (const auto& edge : graph.GetEdges()) {
+            if (!(edge.weight >= 0.0)) {
+                throw std::invalid_argument("Landmarks: edge weights must be non-negative");
+            }
+            reversed.push_back({edge.to, edge.from, edge.weight});
+            has_edges[edge.from] = has_edges[edge.to] = true;
+        }
+        const DirectedWeightedGraph<double> reverse_graph(vertex_count, std::move(reversed));
+
+        // Round trip distance to the nearest landmark so far. Vertices no landmark can reach
+        // come first, so that every part of a disconnected network gets a landmark
+        std::vector<double> nearest(vertex_count, INF);
+        std::vector<std::vector<float>> from_landmark;
+        std::vector<std::vector<float>> to_landmark;
+        auto pick_farthest = [&](const std::vector<double>& score) {
+            std::optional<VertexId> best;
+            for (VertexId v = 0; v < vertex_count; ++v) {
+                if (has_edges[v] && score[v] > 0.0 && (!best || score[v] > score[*best])) {
+                    best = v;
+                }
+            }
+            return best;
+        };
+
+        // The first landmark is the vertex farthest from some vertex that has edges
+        std::optional<VertexId> next;
+        if (vertex_count > 0) {
+            const auto origin = static_cast<VertexId>(std::find(has_edges.begin(), has_edges.end(), true) - has_edges.begin());
+            if (origin == vertex_count) {
+                next = 0;
+            } else {
+                std::vector<double> start = ShortestDistances(graph, origin);
+                std::replace(start.begin(), start.end(), INF, 0.0);
+                next = pick_farthest(start).value_or(origin);
+            }
+        }
+        while (next && landmarks_.size() < std::min(count, vertex_count)) {
+            landmarks_.push_back(*next);
+            const std::vector<double> from = ShortestDistances(graph, *next);
+            const std::vector<double> to = ShortestDistances(reverse_graph, *next);
+            for (VertexId v = 0; v < vertex_count; ++v) {
+                nearest[v] = std::min(nearest[v], from[v] + to[v]);
+            }
+            from_landmark.emplace_back(from.begin(), from.end());
+            to_landmark.emplace_back(to.begin(), to.end());
+            next = pick_farthest(nearest);
+        }
+
+        const size_t landmark_count = landmarks_.size();
+        distances_.resize(vertex_count * 2 * landmark_count);
+        for (VertexId v = 0; v < vertex_count; ++v) {
+            float* row = &distances_[v * 2 * landmark_count];
+            for (size_t i = 0; i < landmark_count; ++i) {
+                row[i] = from_landmark[i][v];
+                row[landmark_count + i] = to_landmark[i][v];
+            }
+        }
+        ComputeSlack();
+    }
+
+    Landmarks::Landmarks(std::vector<VertexId> landmarks, std::vector<float> distances, uint64_t graph_hash)
+            : landmarks_(std::move(landmarks)), distances_(std::move(distances)), graph_hash_(graph_hash) {
+        if (landmarks_.empty() ? !distances_.empty() : distances_.size() % (2 * landmarks_.size()) != 0) {
+            throw std::invalid_argument("Landmarks: distance table does not fit the landmarks");
+        }
+        const size_t vertex_count = GetVertexCount();
+        for (size_t i = 0; i < landmarks_.size(); ++i) {
+            const VertexId landmark = landmarks_[i];
+            if (landmark >= vertex_count || distances_[landmark * 2 * landmarks_.size() + i] != 0.0f) {
+                throw std::invalid_argument("Landmarks: bad landmark");
+            }
+        }
+        if (std::any_of(distances_.begin(), distances_.end(), [](float d) { return !(d >= 0.0f); })) {
+            throw std::invalid_argument("Landmarks: distances must be non-negative");
+        }
+        ComputeSlack();
+    }
+
+    void Landmarks::ComputeSlack() {
+        // A float keeps 24 significant bits, so each stored distance is off by at most
+        // 2^-24 of the largest one, and a bound subtracting two of them by twice that
+        float largest = 0.0f;
+        for (const float d : distances_) {
+            if (std::isfinite(d)) {
+                largest = std::max(largest, d);
+            }
+        }
+        slack_ = std::ldexp(static_cast<double>(largest), -22);
+    }
+
+    bool Landmarks::Matches(const DirectedWeightedGraph<double>& graph) const {
+        return GetVertexCount() == graph.GetVertexCount() && graph_hash_ == HashGraph(graph);
+    }
+
+    uint64_t Landmarks::HashGraph(const DirectedWeightedGraph<double>& graph) {
+        uint64_t hash = Mix(0, graph.GetVertexCount());
+        for (const auto& edge : graph.GetEdges()) {
+            hash = Mix(hash, (static_cast<uint64_t>(edge.from) << 32) | edge.to);
+            hash = Mix(hash, std::bit_cast<uint64_t>(edge.weight));
+        }
+        return hash;
+    }
+
+    double Landmarks::LowerBound(VertexId v, const float* target) const {
+        const size_t count = landmarks_.size();
+        const float* row = &distances_[v * 2 * count];
+        double bound = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            // A landmark that reaches v but not the target proves that v does not reach it either,
+            // which the infinite difference expresses; so does one that the target reaches but v does not
+            if (std::isfinite(row[i])) {
+                bound = std::max(bound, static_cast<double>(target[i]) - row[i]);
+            }
+            if (std::isfinite(target[count + i])) {
+                bound = std::max(bound, static_cast<double>(row[count + i]) - target[count + i]);
+            }
+        }
+        return std::max(0.0, bound - slack_);
+    }
+
+    // Working arrays of a query, kept per thread and reset lazily like those of graph::Router
+    struct Landmarks::Scratch {
+        std::vector<double> distance;
+        std::vector<double> bound;
+        std::vector<EdgeId> prev_edge;
+        std::vector<uint32_t> stamp;
+        uint32_t generation = 0;
+        std::vector<std::pair<double, VertexId>> heap;
+
+        static Scratch& Get(size_t vertex_count) {
+            thread_local Scratch scratch;
+            if (scratch.stamp.size() < vertex_count) {
+                scratch.distance.resize(vertex_count);
+                scratch.bound.resize(vertex_count);
+                scratch.prev_edge.resize(vertex_count);
+                scratch.stamp.resize(vertex_count, 0);
+            }
+            if (++scratch.generation == 0) {
+                std::fill(scratch.stamp.begin(), scratch.stamp.end(), 0);
+                scratch.generation = 1;
+            }
+            scratch.heap.clear();
+            return scratch;
+        }
+    };
+
+    std::optional<Router<double>::RouteInfo> Landmarks::BuildRoute(const DirectedWeightedGraph<double>& graph,
+                                                                   VertexId from, VertexId to) const {
+        const size_t vertex_count = GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count || graph.GetVertexCount() != vertex_count) {
+            return std::nullopt;
+        }
+
+        Scratch& s = Scratch::Get(vertex_count);
+        const float* target = &distances_[to * 2 * landmarks_.size()];
+        const auto by_key = std::greater<>{};
+        auto reached = [&s](VertexId v) { return s.stamp[v] == s.generation; };
+
+        s.stamp[from] = s.generation;
+        s.distance[from] = 0.0;
+        s.bound[from] = LowerBound(from, target);
+        s.prev_edge[from] = NO_EDGE;
+        s.heap.emplace_back(s.bound[from], from);
+        while (!s.heap.empty()) {
+            std::pop_heap(s.heap.begin(), s.heap.end(), by_key);
+            const auto [key, vertex] = s.heap.back();
+            s.heap.pop_back();
+            if (key > s.distance[vertex] + s.bound[vertex]) {
+                continue;  // stale heap entry
+            }
+            if (vertex == to) {
+                break;
+            }
+            for (const auto& edge : graph.GetIncidentEdges(vertex)) {
+                const double candidate = s.distance[vertex] + edge.weight;
+                if (!reached(edge.to)) {
+                    s.stamp[edge.to] = s.generation;
+                    s.bound[edge.to] = LowerBound(edge.to, target);
+                } else if (candidate >= s.distance[edge.to]) {
+                    continue;
+                }
+                s.distance[edge.to] = candidate;
+                s.prev_edge[edge.to] = edge.id;
+                // An infinite bound means the target cannot be reached from there
+                if (s.bound[edge.to] != INF) {
+                    s.heap.emplace_back(candidate + s.bound[edge.to], edge.to);
+                    std::push_heap(s.heap.begin(), s.heap.end(), by_key);
+                }
+            }
+        }
+
+        if (!reached(to)) {
+            return std::nullopt;
+        }
+        Router<double>::RouteInfo route{s.distance[to], {}};
+        for (EdgeId id = s.prev_edge[to]; id != NO_EDGE; id = s.prev_edge[graph.GetEdge(id).from]) {
+            route.edges.push_back(id);
+        }
+        std::reverse(route.edges.begin(), route.edges.end());
+        return route;
+    }
+
+} // namespace graph
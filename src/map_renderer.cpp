@@ -1,6 +1,9 @@
 #include "map_renderer.h"
 
+#include <functional>
+#include <ios>
 #include <set>
+#include <sstream>
 
 using namespace std;
 
@@ -10,6 +13,20 @@ constexpr const char* FONT_COLOR = "black";
 
 namespace transport_catalogue::renderer {
 
+    // Fingerprint of every setting that affects the picture. Numbers are printed
+    // as hex floats so that no change gets lost to rounding
+    static uint64_t HashSettings(const RenderSettings& s) {
+        ostringstream text;
+        text << hexfloat << s.width << ' ' << s.height << ' ' << s.padding << ' ' << s.line_width << ' '
+             << s.stop_radius << ' ' << s.bus_label_font_size << ' ' << s.bus_label_offset.x << ' '
+             << s.bus_label_offset.y << ' ' << s.stop_label_font_size << ' ' << s.stop_label_offset.x << ' '
+             << s.stop_label_offset.y << ' ' << s.underlayer_color << ' ' << s.underlayer_width;
+        for (const auto& color : s.color_palette) {
+            text << ' ' << color;
+        }
+        return hash<string>{}(text.str());
+    }
+
     static bool BusLessByName(const Bus* a, const Bus* b) {
         return a->name < b->name;
     }
@@ -26,15 +43,37 @@ namespace transport_catalogue::renderer {
     }
 
     static vector<const Stop*> CollectPlottedStopsSorted(const TransportCatalogue& db) {
-        unordered_set<const Stop*> used;
-        for (const auto& bus : db.GetAllBuses()) {
-            for (auto* s : bus.stops) if (s) used.insert(s);
+        vector<bool> used(db.GetStopCount(), false);
+        for (BusId bus = 0; bus < db.GetBusCount(); ++bus) {
+            for (StopId s : db.GetRoute(bus)) used[s] = true;
+        }
+        vector<const Stop*> out;
+        for (StopId s = 0; s < used.size(); ++s) {
+            if (used[s]) out.push_back(&db.GetStop(s));
         }
-        vector<const Stop*> out(used.begin(), used.end());
         sort(out.begin(), out.end(), [](const Stop* a, const Stop* b){ return a->name < b->name; });
         return out;
     }
 
+    struct MapRenderer::Layout {
+        // Buses without stops are left out, so a bus's colour is its number in the list
+        vector<const Bus*> buses;
+        vector<const Stop*> stops;
+        detail::SphereProjector proj;
+    };
+
+    MapRenderer::Layout MapRenderer::MakeLayout(const TransportCatalogue& db) const {
+        auto buses = GetBusesSorted(db);
+        auto stops = CollectPlottedStopsSorted(db);
+
+        std::vector<geo::Coordinates> coords;
+        coords.reserve(stops.size());
+        for (auto* s : stops) coords.push_back(s->coordinates);
+        detail::SphereProjector proj(coords.begin(), coords.end(),
+                             settings_.width, settings_.height, settings_.padding);
+        return {std::move(buses), std::move(stops), proj};
+    }
+
     svg::Text MapRenderer::MakeBusTextUnderlayer(svg::Point p, std::string_view name) const {
         svg::Text t;
         t.SetPosition(p)
@@ -93,28 +132,20 @@ namespace transport_catalogue::renderer {
         return settings_.color_palette[i % settings_.color_palette.size()];
     }
 
-    void MapRenderer::RenderBusLines(svg::Document& doc,
-                                     const std::vector<const Bus*>& buses,
-                                     const detail::SphereProjector& proj,
-                                     std::vector<size_t>& bus_color_index) const {
-        size_t color_idx = 0;
-        for (size_t i = 0; i < buses.size(); ++i) {
-            const Bus* bus = buses[i];
-            if (bus->stops.empty()) continue;
-
-            bus_color_index[i] = color_idx;
-            const auto& color = ColorForIndex(color_idx++);
+    void MapRenderer::RenderBusLines(svg::Document& doc, const Layout& layout, size_t first, size_t last) const {
+        for (size_t i = first; i < last; ++i) {
+            const Bus* bus = layout.buses[i];
             svg::Polyline pl;
             pl.SetFillColor(svg::NoneColor)
-                    .SetStrokeColor(color)
+                    .SetStrokeColor(ColorForIndex(i))
                     .SetStrokeWidth(settings_.line_width)
                     .SetStrokeLineCap(svg::StrokeLineCap::ROUND)
                     .SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 
-            for (const Stop* s : bus->stops) pl.AddPoint(proj(s->coordinates));
+            for (const Stop* s : bus->stops) pl.AddPoint(layout.proj(s->coordinates));
             if (!bus->is_roundtrip && bus->stops.size() > 1) {
                 for (size_t k = bus->stops.size() - 2; k < bus->stops.size(); --k) {
-                    pl.AddPoint(proj(bus->stops[k]->coordinates));
+                    pl.AddPoint(layout.proj(bus->stops[k]->coordinates));
                     if (k == 0) break;
                 }
             }
@@ -122,67 +153,142 @@ namespace transport_catalogue::renderer {
         }
     }
 
-    void MapRenderer::RenderBusLabels(svg::Document& doc,
-                                      const std::vector<const Bus*>& buses,
-                                      const detail::SphereProjector& proj,
-                                      const std::vector<size_t>& bus_color_index) const {
-        for (size_t i = 0; i < buses.size(); ++i) {
-            const Bus* bus = buses[i];
-            if (bus->stops.empty()) continue;
-
-            const auto& color = ColorForIndex(bus_color_index[i]);
-            const Stop* first = bus->stops.front();
-            doc.Add(MakeBusTextUnderlayer(proj(first->coordinates), bus->name));
-            doc.Add(MakeBusText(proj(first->coordinates), bus->name, color));
+    void MapRenderer::RenderBusLabels(svg::Document& doc, const Layout& layout, size_t first, size_t last) const {
+        for (size_t i = first; i < last; ++i) {
+            const Bus* bus = layout.buses[i];
+            const auto& color = ColorForIndex(i);
+            const Stop* first_stop = bus->stops.front();
+            doc.Add(MakeBusTextUnderlayer(layout.proj(first_stop->coordinates), bus->name));
+            doc.Add(MakeBusText(layout.proj(first_stop->coordinates), bus->name, color));
 
             if (!bus->is_roundtrip) {
-                const Stop* last = bus->stops.back();
-                if (last != first) {
-                    doc.Add(MakeBusTextUnderlayer(proj(last->coordinates), bus->name));
-                    doc.Add(MakeBusText(proj(last->coordinates), bus->name, color));
+                const Stop* last_stop = bus->stops.back();
+                if (last_stop != first_stop) {
+                    doc.Add(MakeBusTextUnderlayer(layout.proj(last_stop->coordinates), bus->name));
+                    doc.Add(MakeBusText(layout.proj(last_stop->coordinates), bus->name, color));
                 }
             }
         }
     }
 
-    void MapRenderer::RenderStopCircles(svg::Document& doc,
-                                        const std::vector<const Stop*>& stops,
-                                        const detail::SphereProjector& proj) const {
-        for (const Stop* s : stops) {
+    void MapRenderer::RenderStopCircles(svg::Document& doc, const Layout& layout, size_t first, size_t last) const {
+        for (size_t i = first; i < last; ++i) {
             doc.Add(svg::Circle()
-                            .SetCenter(proj(s->coordinates))
+                            .SetCenter(layout.proj(layout.stops[i]->coordinates))
                             .SetRadius(settings_.stop_radius)
                             .SetFillColor("white"));
         }
     }
 
-    void MapRenderer::RenderStopLabels(svg::Document& doc,
-                                       const std::vector<const Stop*>& stops,
-                                       const detail::SphereProjector& proj) const {
-        for (const Stop* s : stops) {
-            doc.Add(MakeStopTextUnderlayer(proj(s->coordinates), s->name));
-            doc.Add(MakeStopText(proj(s->coordinates), s->name));
+    void MapRenderer::RenderStopLabels(svg::Document& doc, const Layout& layout, size_t first, size_t last) const {
+        for (size_t i = first; i < last; ++i) {
+            const Stop* s = layout.stops[i];
+            doc.Add(MakeStopTextUnderlayer(layout.proj(s->coordinates), s->name));
+            doc.Add(MakeStopText(layout.proj(s->coordinates), s->name));
         }
     }
 
-    svg::Document MapRenderer::Render(const TransportCatalogue& db) const {
-        svg::Document doc;
+    void MapRenderer::SetSettings(RenderSettings s) {
+        settings_ = std::move(s);
+        settings_hash_ = HashSettings(settings_);
+    }
 
-        auto buses = GetBusesSorted(db);
-        auto stops = CollectPlottedStopsSorted(db);
+    void MapRenderer::ForEach(size_t count, const function<void(size_t)>& body) const {
+        if (pool_) {
+            pool_->ParallelFor(count, body);
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+    }
 
-        std::vector<geo::Coordinates> coords;
-        coords.reserve(stops.size());
-        for (auto* s : stops) coords.push_back(s->coordinates);
-        detail::SphereProjector proj(coords.begin(), coords.end(),
-                             settings_.width, settings_.height, settings_.padding);
+    vector<svg::Document> MapRenderer::RenderParts(const TransportCatalogue& db) const {
+        const Layout layout = MakeLayout(db);
+        using LayerFunction = void (MapRenderer::*)(svg::Document&, const Layout&, size_t, size_t) const;
+        struct Chunk {
+            LayerFunction layer;
+            size_t first;
+            size_t last;
+        };
+        vector<Chunk> chunks;
+        const auto add_layer = [&chunks](LayerFunction layer, size_t count) {
+            for (size_t first = 0; first < count; first += CHUNK_SIZE) {
+                chunks.push_back({layer, first, min(first + CHUNK_SIZE, count)});
+            }
+        };
+        add_layer(&MapRenderer::RenderBusLines, layout.buses.size());
+        add_layer(&MapRenderer::RenderBusLabels, layout.buses.size());
+        add_layer(&MapRenderer::RenderStopCircles, layout.stops.size());
+        add_layer(&MapRenderer::RenderStopLabels, layout.stops.size());
+
+        vector<svg::Document> parts(chunks.size());
+        ForEach(chunks.size(), [&](size_t i) {
+            (this->*chunks[i].layer)(parts[i], layout, chunks[i].first, chunks[i].last);
+        });
+        return parts;
+    }
+
+    shared_ptr<const string> MapRenderer::RenderSvgText(const TransportCatalogue& db) const {
+        // Callers that come while the map is being rendered wait for it instead of rendering it again
+        lock_guard lock(svg_cache_.mutex);
+        if (svg_cache_.svg && svg_cache_.catalogue_version == db.GetVersion()
+            && svg_cache_.settings_hash == settings_hash_) {
+            return svg_cache_.svg;
+        }
+
+        vector<string> texts;
+        {
+            const vector<svg::Document> parts = RenderParts(db);
+            texts.resize(parts.size());
+            ForEach(parts.size(), [&](size_t i) {
+                ostringstream text;
+                {
+                    svg::Writer writer(text);
+                    parts[i].RenderObjects(writer);
+                }
+                texts[i] = std::move(text).str();
+            });
+        }
+
+        ostringstream begin;
+        ostringstream end;
+        {
+            svg::Writer begin_writer(begin);
+            svg::Document::RenderBegin(begin_writer);
+            svg::Writer end_writer(end);
+            svg::Document::RenderEnd(end_writer);
+        }
+        size_t size = begin.view().size() + end.view().size();
+        for (const string& text : texts) {
+            size += text.size();
+        }
+        string svg;
+        svg.reserve(size);
+        svg += begin.view();
+        for (string& text : texts) {
+            svg += text;
+            string().swap(text);
+        }
+        svg += end.view();
+        svg_cache_.svg = make_shared<const string>(std::move(svg));
+        svg_cache_.catalogue_version = db.GetVersion();
+        svg_cache_.settings_hash = settings_hash_;
+        return svg_cache_.svg;
+    }
 
-        std::vector<size_t> bus_color_index(buses.size());
-        RenderBusLines(doc, buses, proj, bus_color_index);
-        RenderBusLabels(doc, buses, proj, bus_color_index);
-        RenderStopCircles(doc, stops, proj);
-        RenderStopLabels(doc, stops, proj);
+    void MapRenderer::RenderSvg(const TransportCatalogue& db, ostream& out) const {
+        const auto svg = RenderSvgText(db);
+        out.write(svg->data(), static_cast<streamsize>(svg->size()));
+    }
 
+    svg::Document MapRenderer::Render(const TransportCatalogue& db) const {
+        const Layout layout = MakeLayout(db);
+        svg::Document doc;
+        RenderBusLines(doc, layout, 0, layout.buses.size());
+        RenderBusLabels(doc, layout, 0, layout.buses.size());
+        RenderStopCircles(doc, layout, 0, layout.stops.size());
+        RenderStopLabels(doc, layout, 0, layout.stops.size());
         return doc;
     }
 
@@ -0,0 +1,126 @@
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace transport_catalogue {
+
+    namespace {
+        // Average number of keys per bucket: larger buckets make the table smaller
+        // but the seeds harder to find
+        constexpr size_t KEYS_PER_BUCKET = 4;
+        constexpr uint32_t MAX_SEED = 1u << 24;
+    }
+
+    PerfectHashIndex::PerfectHashIndex(const std::vector<std::pair<std::string_view, uint32_t>>& items) {
+        const size_t n = items.size();
+        if (n == 0) {
+            return;
+        }
+
+        std::vector<uint64_t> hashes(n);
+        for (size_t i = 0; i < n; ++i) {
+            hashes[i] = Hash(items[i].first);
+        }
+
+        seeds_.assign(n / KEYS_PER_BUCKET + 1, 0);
+        std::vector<std::vector<uint32_t>> buckets(seeds_.size());
+        for (uint32_t i = 0; i < n; ++i) {
+            buckets[Bucket(hashes[i])].push_back(i);
+        }
+
+        // Large buckets first, while the table still has plenty of free slots
+        std::vector<uint32_t> order(buckets.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t lhs, uint32_t rhs) {
+            return buckets[lhs].size() > buckets[rhs].size();
+        });
+
+        ids_.assign(n, INVALID_ID);
+        fingerprints_.assign(n, 0);
+        std::vector<bool> taken(n, false);
+        std::vector<uint64_t> slots;
+
+        for (uint32_t b : order) {
+            const auto& keys = buckets[b];
+            if (keys.empty()) {
+                break;
+            }
+            uint32_t seed = 0;
+            for (;; ++seed) {
+                if (seed == MAX_SEED) {
+                    throw std::logic_error("PerfectHashIndex: cannot place keys, are they distinct?");
+                }
+                slots.clear();
+                bool fits = true;
+                for (uint32_t key : keys) {
+                    const uint64_t slot = Slot(hashes[key], seed, n);
+                    if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                        fits = false;
+                        break;
+                    }
+                    slots.push_back(slot);
+                }
+                if (fits) {
+                    break;
+                }
+            }
+
+            seeds_[b] = seed;
+            for (size_t k = 0; k < keys.size(); ++k) {
+                taken[slots[k]] = true;
+                ids_[slots[k]] = items[keys[k]].second;
+                fingerprints_[slots[k]] = Fingerprint(hashes[keys[k]]);
+            }
+        }
+    }
+
+    PerfectHashIndex::PerfectHashIndex(std::vector<uint32_t> seeds, std::vector<uint32_t> ids,
+                                       std::vector<uint16_t> fingerprints)
+            : seeds_(std::move(seeds))
+            , ids_(std::move(ids))
+            , fingerprints_(std::move(fingerprints)) {
+        if (fingerprints_.size() != ids_.size() || (!ids_.empty() && seeds_.empty())) {
+            throw std::logic_error("PerfectHashIndex: inconsistent table arrays");
+        }
+    }
+
+    uint32_t PerfectHashIndex::Find(std::string_view name) const {
+        if (ids_.empty()) {
+            return INVALID_ID;
+        }
+        const uint64_t hash = Hash(name);
+        const uint64_t slot = Slot(hash, seeds_[Bucket(hash)], ids_.size());
+        return fingerprints_[slot] == Fingerprint(hash) ? ids_[slot] : INVALID_ID;
+    }
+
+    size_t PerfectHashIndex::MemoryUsage() const {
+        return seeds_.capacity() * sizeof(uint32_t) + ids_.capacity() * sizeof(uint32_t)
+               + fingerprints_.capacity() * sizeof(uint16_t);
+    }
+
+    // splitmix64 finalizer
+    static uint64_t Mix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    uint64_t PerfectHashIndex::Hash(std::string_view name) {
+        // FNV-1a rather than std::hash: the value must not depend on the standard library,
+        // since built tables are saved to snapshots
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (const char c : name) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+        }
+        return Mix(hash);
+    }
+
+    uint64_t PerfectHashIndex::Slot(uint64_t hash, uint32_t seed, size_t size) {
+        // Every seed gives an independent-looking slot for the same hash
+        return Mix(hash + (uint64_t{seed} + 1) * 0x9E3779B97F4A7C15ull) % size;
+    }
+
+} // namespace transport_catalogue
@@ -4,25 +4,42 @@
 
 namespace transport_catalogue {
 
-    RequestHandler::RequestHandler(const TransportCatalogue& db, const renderer::MapRenderer& renderer)
-            : db_(db), renderer_(renderer) {}
+    RequestHandler::RequestHandler(const TransportCatalogue& db, const renderer::MapRenderer& renderer,
+                                   const router::TransportRouter* router)
+            : db_(db), renderer_(renderer), router_(router) {}
 
     [[nodiscard]] std::optional<BusInfo> RequestHandler::GetBusInfo(const std::string_view& bus_name) const {
         return db_.GetBusInfo(bus_name);
     }
 
-    [[nodiscard]] const std::unordered_set<const Bus*>* RequestHandler::GetBusesByStop(const std::string_view& stop_name) const {
+    [[nodiscard]] std::optional<std::span<const Bus* const>> RequestHandler::GetBusesByStop(const std::string_view& stop_name) const {
         const Stop* stop = db_.FindStop(stop_name);
         if (!stop) {
-            return nullptr;
+            return std::nullopt;
         }
 
-        return &db_.GetBusesForStop(stop);
+        return db_.GetBusesForStop(stop);
+    }
+
+    std::vector<StopDistance> RequestHandler::GetNearbyStops(geo::Coordinates center, double radius,
+                                                             size_t limit) const {
+        return db_.FindNearbyStops(center, radius, limit);
+    }
+
+    std::optional<router::RouteInfo> RequestHandler::BuildRoute(std::string_view from, std::string_view to) const {
+        if (!router_) {
+            return std::nullopt;
+        }
+        return router_->BuildRoute(db_.FindStop(from), db_.FindStop(to));
     }
 
     svg::Document RequestHandler::RenderMap() const {
         return renderer_.Render(db_);
     }
 
+    void RequestHandler::RenderMapSvg(std::ostream& out) const {
+        renderer_.RenderSvg(db_, out);
+    }
+
 }
 
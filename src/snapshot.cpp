@@ -0,0 +1,486 @@
+#include "snapshot.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TC_SNAPSHOT_MMAP 1
+#endif
+
+namespace transport_catalogue::snapshot {
+
+    namespace {
+
+        constexpr std::array<char, 8> MAGIC = {'T', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+        constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        enum Section : uint32_t {
+            STRINGS,
+            STOP_NAMES,
+            STOP_COORDINATES,
+            BUSES,
+            ROUTE_OFFSETS,
+            ROUTE_STOPS,
+            DISTANCE_OFFSETS,
+            DISTANCES,
+            STOP_BUS_OFFSETS,
+            STOP_BUSES,
+            BUS_INFOS,
+            STOP_HASH_SEEDS,
+            STOP_HASH_IDS,
+            STOP_HASH_FINGERPRINTS,
+            BUS_HASH_SEEDS,
+            BUS_HASH_IDS,
+            BUS_HASH_FINGERPRINTS,
+            SPATIAL_ORDER,
+            RENDER_SETTINGS,
+            ROUTING_SETTINGS,
+            ROUTE_LANDMARKS,
+            ROUTE_LANDMARK_DISTANCES,
+            SECTION_COUNT
+        };
+
+        struct SectionEntry {
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        struct Header {
+            std::array<char, 8> magic;
+            uint32_t version;
+            uint32_t byte_order;
+            uint32_t stop_count;
+            uint32_t bus_count;
+            std::array<SectionEntry, SECTION_COUNT> sections;
+        };
+
+        // A name in the string table
+        struct NameRecord {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        struct BusRecord {
+            NameRecord name;
+            uint32_t is_roundtrip;
+            uint32_t reserved;
+        };
+
+        struct DistanceRecord {
+            uint32_t to;
+            uint32_t reserved;
+            double distance;
+        };
+
+        struct BusInfoRecord {
+            uint64_t stops_count;
+            uint64_t unique_stops_count;
+            double route_length;
+            double curvature;
+        };
+
+        struct RoutingRecord {
+            double bus_wait_time;
+            double bus_velocity;
+            uint64_t graph_hash;  // of the landmark index, if there is one
+        };
+
+        constexpr size_t ALIGNMENT = 8;
+
+    } // namespace
+
+    // Has access to the private arrays of TransportCatalogue
+    class Access {
+    public:
+        static std::string Save(const TransportCatalogue& db, const json::Node& render_settings,
+                                const router::TransportRouter* router);
+        static json::Node Load(std::string_view data, TransportCatalogue& db, std::optional<RouteIndex>* route_index);
+    };
+
+    namespace {
+
+        class SectionWriter {
+        public:
+            SectionWriter() {
+                out_.resize(sizeof(Header));
+            }
+
+            template <typename T>
+            void Add(Section section, const T* data, size_t count) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                out_.resize((out_.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+                header_.sections[section] = {out_.size(), count * sizeof(T)};
+                out_.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+            }
+
+            template <typename T>
+            void Add(Section section, const std::vector<T>& items) {
+                Add(section, items.data(), items.size());
+            }
+
+            std::string Finish(uint32_t stop_count, uint32_t bus_count) && {
+                header_.magic = MAGIC;
+                header_.version = VERSION;
+                header_.byte_order = BYTE_ORDER_MARK;
+                header_.stop_count = stop_count;
+                header_.bus_count = bus_count;
+                std::memcpy(out_.data(), &header_, sizeof(Header));
+                return std::move(out_);
+            }
+
+        private:
+            Header header_{};
+            std::string out_;
+        };
+
+        class SectionReader {
+        public:
+            explicit SectionReader(std::string_view data) : data_(data) {
+                if (data.size() < sizeof(Header)) {
+                    throw SnapshotError("Snapshot is truncated");
+                }
+                std::memcpy(&header_, data.data(), sizeof(Header));
+                if (header_.magic != MAGIC) {
+                    throw SnapshotError("Not a catalogue snapshot");
+                }
+                if (header_.byte_order != BYTE_ORDER_MARK) {
+                    throw SnapshotError("Snapshot was written on a machine with another byte order");
+                }
+                if (header_.version != VERSION) {
+                    throw SnapshotError("Unsupported snapshot version " + std::to_string(header_.version));
+                }
+                for (const auto& [offset, size] : header_.sections) {
+                    if (offset > data.size() || size > data.size() - offset) {
+                        throw SnapshotError("Snapshot section is out of file bounds");
+                    }
+                }
+            }
+
+            [[nodiscard]] const Header& GetHeader() const { return header_; }
+
+            [[nodiscard]] std::string_view Raw(Section section) const {
+                const auto& [offset, size] = header_.sections[section];
+                return data_.substr(offset, size);
+            }
+
+            // Copies a section of `expected` elements of type T
+            template <typename T>
+            std::vector<T> Read(Section section, size_t expected) const {
+                static_assert(std::is_trivially_copyable_v<T>);
+                const std::string_view raw = Raw(section);
+                if (raw.size() != expected * sizeof(T)) {
+                    throw SnapshotError("Snapshot section has unexpected size");
+                }
+                std::vector<T> items(expected);
+                if (expected > 0) {
+                    std::memcpy(items.data(), raw.data(), raw.size());
+                }
+                return items;
+            }
+
+            template <typename T>
+            std::vector<T> Read(Section section) const {
+                return Read<T>(section, Raw(section).size() / sizeof(T));
+            }
+
+        private:
+            std::string_view data_;
+            Header header_{};
+        };
+
+        // Offsets must start at zero, never decrease and end at `total`
+        void CheckOffsets(const std::vector<uint32_t>& offsets, size_t total) {
+            if (offsets.empty() || offsets.front() != 0 || offsets.back() != total
+                || !std::is_sorted(offsets.begin(), offsets.end())) {
+                throw SnapshotError("Snapshot has inconsistent offsets");
+            }
+        }
+
+    } // namespace
+
+    std::string Access::Save(const TransportCatalogue& db, const json::Node& render_settings,
+                             const router::TransportRouter* router) {
+        const bool frozen = db.names_frozen_ && db.pending_distances_.empty()
+                            && db.distance_offsets_.size() == db.stops_.size() + 1
+                            && db.bus_infos_.size() == db.buses_.size()
+                            && db.spatial_index_.Size() == db.stops_.size();
+        if (!frozen) {
+            throw std::logic_error("snapshot::Save: the catalogue must be frozen");
+        }
+
+        std::string strings;
+        auto add_name = [&strings](const std::string& name) {
+            const NameRecord record{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(name.size())};
+            strings += name;
+            return record;
+        };
+
+        std::vector<NameRecord> stop_names;
+        stop_names.reserve(db.stops_.size());
+        for (const Stop& stop : db.stops_) {
+            stop_names.push_back(add_name(stop.name));
+        }
+
+        std::vector<BusRecord> buses;
+        std::vector<BusInfoRecord> bus_infos;
+        buses.reserve(db.buses_.size());
+        for (const Bus& bus : db.buses_) {
+            buses.push_back({add_name(bus.name), bus.is_roundtrip ? 1u : 0u, 0});
+            const BusInfo& info = db.bus_infos_[bus.id];
+            bus_infos.push_back({info.stops_count, info.unique_stops_count, info.route_length, info.curvature});
+        }
+
+        std::vector<DistanceRecord> distances;
+        distances.reserve(db.distances_.size());
+        for (const auto& [to, distance] : db.distances_) {
+            distances.push_back({to, 0, distance});
+        }
+
+        std::vector<uint32_t> stop_bus_offsets{0};
+        std::vector<BusId> stop_buses;
+        for (const auto& stop_buses_list : db.stop_to_buses_) {
+            for (const Bus* bus : stop_buses_list) {
+                stop_buses.push_back(bus->id);
+            }
+            stop_bus_offsets.push_back(static_cast<uint32_t>(stop_buses.size()));
+        }
+
+        std::ostringstream settings;
+        json::Print(json::Document{render_settings}, settings, {true});
+        const std::string settings_text = settings.str();
+
+        SectionWriter writer;
+        writer.Add(STRINGS, strings.data(), strings.size());
+        writer.Add(STOP_NAMES, stop_names);
+        writer.Add(STOP_COORDINATES, db.stop_coordinates_);
+        writer.Add(BUSES, buses);
+        writer.Add(ROUTE_OFFSETS, db.route_offsets_);
+        writer.Add(ROUTE_STOPS, db.route_stops_);
+        writer.Add(DISTANCE_OFFSETS, db.distance_offsets_);
+        writer.Add(DISTANCES, distances);
+        writer.Add(STOP_BUS_OFFSETS, stop_bus_offsets);
+        writer.Add(STOP_BUSES, stop_buses);
+        writer.Add(BUS_INFOS, bus_infos);
+        writer.Add(STOP_HASH_SEEDS, db.stops_names_.GetSeeds());
+        writer.Add(STOP_HASH_IDS, db.stops_names_.GetIds());
+        writer.Add(STOP_HASH_FINGERPRINTS, db.stops_names_.GetFingerprints());
+        writer.Add(BUS_HASH_SEEDS, db.buses_names_.GetSeeds());
+        writer.Add(BUS_HASH_IDS, db.buses_names_.GetIds());
+        writer.Add(BUS_HASH_FINGERPRINTS, db.buses_names_.GetFingerprints());
+        writer.Add(SPATIAL_ORDER, db.spatial_index_.GetOrder());
+        writer.Add(RENDER_SETTINGS, settings_text.data(), settings_text.size());
+        // Empty routing sections mean there is no route index
+        if (router) {
+            const graph::Landmarks* landmarks = router->GetIndex();
+            const RoutingRecord routing{router->GetSettings().bus_wait_time, router->GetSettings().bus_velocity,
+                                        landmarks ? landmarks->GetGraphHash() : 0};
+            writer.Add(ROUTING_SETTINGS, &routing, 1);
+            if (landmarks) {
+                writer.Add(ROUTE_LANDMARKS, landmarks->GetLandmarks());
+                writer.Add(ROUTE_LANDMARK_DISTANCES, landmarks->GetDistances());
+            }
+        }
+        return std::move(writer).Finish(static_cast<uint32_t>(db.stops_.size()),
+                                        static_cast<uint32_t>(db.buses_.size()));
+    }
+
+    json::Node Access::Load(std::string_view data, TransportCatalogue& db, std::optional<RouteIndex>* route_index) {
+        if (!db.stops_.empty() || !db.buses_.empty()) {
+            throw std::logic_error("snapshot::Load: the catalogue must be empty");
+        }
+
+        const SectionReader reader(data);
+        const size_t stop_count = reader.GetHeader().stop_count;
+        const size_t bus_count = reader.GetHeader().bus_count;
+        const std::string_view strings = reader.Raw(STRINGS);
+        auto name_of = [strings](const NameRecord& record) {
+            if (record.offset > strings.size() || record.length > strings.size() - record.offset) {
+                throw SnapshotError("Snapshot name is out of the string table");
+            }
+            return std::string(strings.substr(record.offset, record.length));
+        };
+
+        db.stop_coordinates_ = reader.Read<geo::Coordinates>(STOP_COORDINATES, stop_count);
+        db.stop_points_ = geo::PointTable(db.stop_coordinates_);
+        db.route_offsets_ = reader.Read<uint32_t>(ROUTE_OFFSETS, bus_count + 1);
+        db.route_stops_ = reader.Read<StopId>(ROUTE_STOPS);
+        db.distance_offsets_ = reader.Read<uint32_t>(DISTANCE_OFFSETS, stop_count + 1);
+        const auto distances = reader.Read<DistanceRecord>(DISTANCES);
+        const auto stop_bus_offsets = reader.Read<uint32_t>(STOP_BUS_OFFSETS, stop_count + 1);
+        const auto stop_buses = reader.Read<BusId>(STOP_BUSES);
+
+        CheckOffsets(db.route_offsets_, db.route_stops_.size());
+        CheckOffsets(db.distance_offsets_, distances.size());
+        CheckOffsets(stop_bus_offsets, stop_buses.size());
+        auto check_ids = [](const auto& ids, size_t count) {
+            for (const uint32_t id : ids) {
+                if (id >= count) {
+                    throw SnapshotError("Snapshot refers to a missing stop or bus");
+                }
+            }
+        };
+        check_ids(db.route_stops_, stop_count);
+        check_ids(stop_buses, bus_count);
+
+        const auto stop_names = reader.Read<NameRecord>(STOP_NAMES, stop_count);
+        for (StopId id = 0; id < stop_count; ++id) {
+            db.stops_.push_back(Stop{name_of(stop_names[id]), db.stop_coordinates_[id], id});
+        }
+
+        const auto buses = reader.Read<BusRecord>(BUSES, bus_count);
+        for (BusId id = 0; id < bus_count; ++id) {
+            Bus bus{name_of(buses[id].name), {}, buses[id].is_roundtrip != 0, id};
+            bus.stops.reserve(db.route_offsets_[id + 1] - db.route_offsets_[id]);
+            for (const StopId stop : db.GetRoute(id)) {
+                bus.stops.push_back(&db.stops_[stop]);
+            }
+            db.buses_.push_back(std::move(bus));
+        }
+
+        // FindDistance scans a row in target order and stops at the first larger target,
+        // so every row must be strictly ordered
+        db.distances_.reserve(distances.size());
+        for (StopId id = 0; id < stop_count; ++id) {
+            for (uint32_t i = db.distance_offsets_[id]; i < db.distance_offsets_[id + 1]; ++i) {
+                const auto& record = distances[i];
+                if (record.to >= stop_count) {
+                    throw SnapshotError("Snapshot refers to a missing stop or bus");
+                }
+                if (i > db.distance_offsets_[id] && record.to <= distances[i - 1].to) {
+                    throw SnapshotError("Snapshot has unordered distances");
+                }
+                db.distances_.push_back({record.to, record.distance});
+            }
+        }
+
+        db.stop_to_buses_.resize(stop_count);
+        for (StopId id = 0; id < stop_count; ++id) {
+            auto& list = db.stop_to_buses_[id];
+            list.reserve(stop_bus_offsets[id + 1] - stop_bus_offsets[id]);
+            for (uint32_t i = stop_bus_offsets[id]; i < stop_bus_offsets[id + 1]; ++i) {
+                list.push_back(&db.buses_[stop_buses[i]]);
+            }
+        }
+
+        db.bus_infos_.reserve(bus_count);
+        for (const auto& record : reader.Read<BusInfoRecord>(BUS_INFOS, bus_count)) {
+            db.bus_infos_.push_back({record.stops_count, record.unique_stops_count, record.route_length, record.curvature});
+        }
+
+        db.stops_names_ = PerfectHashIndex(reader.Read<uint32_t>(STOP_HASH_SEEDS), reader.Read<uint32_t>(STOP_HASH_IDS),
+                                           reader.Read<uint16_t>(STOP_HASH_FINGERPRINTS));
+        db.buses_names_ = PerfectHashIndex(reader.Read<uint32_t>(BUS_HASH_SEEDS), reader.Read<uint32_t>(BUS_HASH_IDS),
+                                           reader.Read<uint16_t>(BUS_HASH_FINGERPRINTS));
+        check_ids(db.stops_names_.GetIds(), stop_count);
+        check_ids(db.buses_names_.GetIds(), bus_count);
+        db.names_frozen_ = true;
+
+        auto spatial_order = reader.Read<StopId>(SPATIAL_ORDER, stop_count);
+        check_ids(spatial_order, stop_count);
+        db.spatial_index_ = StopSpatialIndex(db.stop_points_, std::move(spatial_order));
+        db.version_ = TransportCatalogue::NextVersion();
+
+        if (route_index) {
+            route_index->reset();
+            const auto routing = reader.Read<RoutingRecord>(ROUTING_SETTINGS);
+            if (routing.size() > 1) {
+                throw SnapshotError("Snapshot section has unexpected size");
+            }
+            if (!routing.empty()) {
+                RouteIndex& index = route_index->emplace();
+                index.settings = {routing.front().bus_wait_time, routing.front().bus_velocity};
+                auto landmarks = reader.Read<graph::VertexId>(ROUTE_LANDMARKS);
+                if (!landmarks.empty()) {
+                    try {
+                        index.landmarks.emplace(std::move(landmarks), reader.Read<float>(ROUTE_LANDMARK_DISTANCES),
+                                                routing.front().graph_hash);
+                    } catch (const std::invalid_argument& e) {
+                        throw SnapshotError(std::string("Snapshot has a broken route index: ") + e.what());
+                    }
+                }
+            }
+        }
+
+        const std::string_view settings = reader.Raw(RENDER_SETTINGS);
+        try {
+            return json::Load(settings).GetRoot();
+        } catch (const json::ParsingError& e) {
+            throw SnapshotError(std::string("Snapshot has broken render settings: ") + e.what());
+        }
+    }
+
+    std::string Save(const TransportCatalogue& db, const json::Node& render_settings,
+                     const router::TransportRouter* router) {
+        return Access::Save(db, render_settings, router);
+    }
+
+    void SaveToFile(const TransportCatalogue& db, const json::Node& render_settings, const std::string& path,
+                    const router::TransportRouter* router) {
+        const std::string data = Access::Save(db, render_settings, router);
+        std::ofstream out(path, std::ios::binary);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            throw SnapshotError("Cannot write snapshot to " + path);
+        }
+    }
+
+    json::Node Load(std::string_view data, TransportCatalogue& db, std::optional<RouteIndex>* route_index) {
+        return Access::Load(data, db, route_index);
+    }
+
+    json::Node LoadFromFile(const std::string& path, TransportCatalogue& db, std::optional<RouteIndex>* route_index) {
+        const MappedFile file(path);
+        return Access::Load(file.GetData(), db, route_index);
+    }
+
+    MappedFile::MappedFile(const std::string& path) {
+#ifdef TC_SNAPSHOT_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw SnapshotError("Cannot open snapshot " + path);
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw SnapshotError("Cannot open snapshot " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw SnapshotError("Cannot map snapshot " + path);
+            }
+            data_ = static_cast<const char*>(mapped);
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw SnapshotError("Cannot open snapshot " + path);
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    MappedFile::~MappedFile() {
+#ifdef TC_SNAPSHOT_MMAP
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+    }
+
+} // namespace transport_catalogue::snapshot
@@ -0,0 +1,134 @@
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace transport_catalogue {
+
+    StopSpatialIndex::StopSpatialIndex(const geo::PointTable& points) {
+        nodes_.reserve(points.Size());
+        for (StopId id = 0; id < points.Size(); ++id) {
+            nodes_.push_back({points.Get(id), id});
+        }
+        Build(0, nodes_.size(), 0);
+    }
+
+    StopSpatialIndex::StopSpatialIndex(const geo::PointTable& points, std::vector<StopId> order) {
+        if (order.size() != points.Size()) {
+            throw std::logic_error("StopSpatialIndex: order does not match the points");
+        }
+        nodes_.reserve(order.size());
+        for (const StopId id : order) {
+            if (id >= points.Size()) {
+                throw std::logic_error("StopSpatialIndex: order refers to a missing point");
+            }
+            nodes_.push_back({points.Get(id), id});
+        }
+    }
+
+    void StopSpatialIndex::Build(size_t lo, size_t hi, int axis) {
+        if (hi - lo <= 1) {
+            return;
+        }
+        const size_t mid = lo + (hi - lo) / 2;
+        std::nth_element(nodes_.begin() + lo, nodes_.begin() + mid, nodes_.begin() + hi,
+                         [axis](const Node& lhs, const Node& rhs) {
+                             return Coordinate(lhs.point, axis) < Coordinate(rhs.point, axis);
+                         });
+        const int next = (axis + 1) % 3;
+        Build(lo, mid, next);
+        Build(mid + 1, hi, next);
+    }
+
+    std::vector<StopId> StopSpatialIndex::GetOrder() const {
+        std::vector<StopId> order;
+        order.reserve(nodes_.size());
+        for (const Node& node : nodes_) {
+            order.push_back(node.id);
+        }
+        return order;
+    }
+
+    // Walks the tree keeping the best candidates in a max-heap by squared chord,
+    // so the farthest kept candidate bounds the search once `limit` are found
+    class StopSpatialIndex::Search {
+    public:
+        Search(const std::vector<Node>& nodes, const geo::UnitVector& center, double max_chord, size_t limit)
+                : nodes_(nodes), center_(center), bound_(max_chord * max_chord), limit_(limit) {
+        }
+
+        void Run(size_t lo, size_t hi, int axis) {
+            if (lo >= hi || limit_ == 0) {
+                return;
+            }
+            const size_t mid = lo + (hi - lo) / 2;
+            const Node& node = nodes_[mid];
+            Consider(node);
+
+            const double diff = Coordinate(center_, axis) - Coordinate(node.point, axis);
+            const int next = (axis + 1) % 3;
+            const auto [near_lo, near_hi, far_lo, far_hi] = diff < 0
+                    ? std::tuple{lo, mid, mid + 1, hi}
+                    : std::tuple{mid + 1, hi, lo, mid};
+            Run(near_lo, near_hi, next);
+            if (diff * diff <= bound_) {
+                Run(far_lo, far_hi, next);
+            }
+        }
+
+        // Candidates nearest first
+        std::vector<std::pair<double, StopId>> Extract() && {
+            std::vector<std::pair<double, StopId>> result = std::move(heap_);
+            std::sort_heap(result.begin(), result.end());
+            return result;
+        }
+
+    private:
+        void Consider(const Node& node) {
+            const double dx = node.point.x - center_.x;
+            const double dy = node.point.y - center_.y;
+            const double dz = node.point.z - center_.z;
+            const double chord2 = dx * dx + dy * dy + dz * dz;
+            if (chord2 > bound_) {
+                return;
+            }
+            heap_.emplace_back(chord2, node.id);
+            std::push_heap(heap_.begin(), heap_.end());
+            if (heap_.size() > limit_) {
+                std::pop_heap(heap_.begin(), heap_.end());
+                heap_.pop_back();
+            }
+            if (heap_.size() == limit_) {
+                bound_ = std::min(bound_, heap_.front().first);
+            }
+        }
+
+        const std::vector<Node>& nodes_;
+        geo::UnitVector center_;
+        double bound_;
+        size_t limit_;
+        std::vector<std::pair<double, StopId>> heap_;
+    };
+
+    std::vector<StopSpatialIndex::Neighbor> StopSpatialIndex::Find(geo::Coordinates center, double radius,
+                                                                   size_t limit) const {
+        // A chord never exceeds 2, so an infinite radius covers the whole sphere
+        const double max_chord = std::isinf(radius) ? 2.0 : geo::DistanceToChord(std::max(radius, 0.0));
+        Search search(nodes_, geo::ToUnitVector(center), max_chord, limit);
+        search.Run(0, nodes_.size(), 0);
+
+        std::vector<Neighbor> result;
+        for (const auto& [chord2, id] : std::move(search).Extract()) {
+            const double distance = geo::ChordToDistance(std::sqrt(chord2));
+            // The chord bound is rounded; the radius itself is the final filter
+            if (distance <= radius) {
+                result.push_back({id, distance});
+            }
+        }
+        return result;
+    }
+
+} // namespace transport_catalogue
@@ -1,5 +1,9 @@
 #include "svg.h"
 
+#include <charconv>
+#include <functional>
+#include <sstream>
+
 namespace transport_catalogue::svg {
 
     using namespace std::literals;
@@ -46,13 +50,118 @@ namespace transport_catalogue::svg {
         return out;
     }
 
-    void Object::Render(const RenderContext& context) const {
-        context.RenderIndent();
+// ---------- Writer ------------------
+
+    Writer::Writer(std::ostream& out)
+            : out_(out) {
+        buffer_.reserve(BUFFER_SIZE);
+    }
+
+    Writer::~Writer() {
+        Flush();
+    }
+
+    void Writer::Flush() {
+        if (!buffer_.empty()) {
+            out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            buffer_.clear();
+        }
+    }
+
+    Writer& Writer::operator<<(std::string_view text) {
+        if (buffer_.size() + text.size() > BUFFER_SIZE) {
+            Flush();
+            // Крупный фрагмент не копируется через буфер
+            if (text.size() >= BUFFER_SIZE) {
+                out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+                return *this;
+            }
+        }
+        buffer_.append(text);
+        return *this;
+    }
+
+    Writer& Writer::operator<<(char c) {
+        if (buffer_.size() >= BUFFER_SIZE) {
+            Flush();
+        }
+        buffer_.push_back(c);
+        return *this;
+    }
+
+    Writer& Writer::operator<<(int value) {
+        char buf[16];
+        const auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        return *this << std::string_view(buf, static_cast<size_t>(ptr - buf));
+    }
 
-        // Делегируем вывод тега своим подклассам
-        RenderObject(context);
+    Writer& Writer::operator<<(uint32_t value) {
+        char buf[16];
+        const auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        return *this << std::string_view(buf, static_cast<size_t>(ptr - buf));
+    }
 
-        context.out << std::endl;
+    Writer& Writer::operator<<(double value) {
+        char buf[32];
+        const auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, 6);
+        return *this << std::string_view(buf, static_cast<size_t>(ptr - buf));
+    }
+
+    Writer& Writer::operator<<(const Color& color) {
+        if (const auto* name = std::get_if<std::string>(&color)) {
+            *this << std::string_view(*name);
+        } else if (const auto* rgb = std::get_if<Rgb>(&color)) {
+            *this << "rgb("sv << int{rgb->red} << ','
+                  << int{rgb->green} << ','
+                  << int{rgb->blue} << ')';
+        } else if (const auto* rgba = std::get_if<Rgba>(&color)) {
+            *this << "rgba("sv << int{rgba->red} << ','
+                  << int{rgba->green} << ','
+                  << int{rgba->blue} << ','
+                  << rgba->opacity << ')';
+        } else {
+            *this << "none"sv;
+        }
+        return *this;
+    }
+
+    Writer& Writer::operator<<(StrokeLineCap cap) {
+        switch (cap) {
+            case StrokeLineCap::BUTT:   return *this << "butt"sv;
+            case StrokeLineCap::ROUND:  return *this << "round"sv;
+            case StrokeLineCap::SQUARE: return *this << "square"sv;
+        }
+        return *this;
+    }
+
+    Writer& Writer::operator<<(StrokeLineJoin join) {
+        switch (join) {
+            case StrokeLineJoin::ARCS:        return *this << "arcs"sv;
+            case StrokeLineJoin::BEVEL:       return *this << "bevel"sv;
+            case StrokeLineJoin::MITER:       return *this << "miter"sv;
+            case StrokeLineJoin::MITER_CLIP:  return *this << "miter-clip"sv;
+            case StrokeLineJoin::ROUND:       return *this << "round"sv;
+        }
+        return *this;
+    }
+
+    void Writer::WriteEscaped(std::string_view text) {
+        size_t run = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            std::string_view entity;
+            switch (text[i]) {
+                case '\"': entity = "&quot;"sv; break;
+                case '\'': entity = "&apos;"sv; break;
+                case '<':  entity = "&lt;"sv; break;
+                case '>':  entity = "&gt;"sv; break;
+                case '&':  entity = "&amp;"sv; break;
+                default:   continue;
+            }
+            // Символы без замены выводятся одним блоком
+            *this << text.substr(run, i - run) << entity;
+            run = i + 1;
+        }
+        *this << text.substr(run);
     }
 
 // ---------- Circle ------------------
@@ -67,14 +176,6 @@ namespace transport_catalogue::svg {
         return *this;
     }
 
-    void Circle::RenderObject(const RenderContext& context) const {
-        auto& out = context.out;
-        out << "<circle cx=\""sv << center_.x << "\" cy=\""sv << center_.y << "\" "sv;
-        out << "r=\""sv << radius_ << "\" "sv;
-        RenderAttrs(context.out);
-        out << "/>"sv;
-    }
-
 // ---------- Polyline ------------------
 
     Polyline& Polyline::AddPoint(Point point) {
@@ -82,21 +183,6 @@ namespace transport_catalogue::svg {
         return *this;
     }
 
-    void Polyline::RenderObject(const RenderContext& context) const {
-        auto& out = context.out;
-        out << "<polyline points=\"";
-        bool first = true;
-        for (const auto& point : points_) {
-            if (!first) out << " ";
-            out << point.x << "," << point.y;
-            first = false;
-        }
-        out << "\"";
-
-        RenderAttrs(context.out);
-        out << "/>"sv;
-    }
-
 // ---------- Text ------------------
 
     Text& Text::SetPosition(Point position) {
@@ -129,57 +215,175 @@ namespace transport_catalogue::svg {
         return *this;
     }
 
-    void Text::RenderObject(const RenderContext& context) const {
-        auto& out = context.out;
-        out << "<text x=\""sv << position_.x << "\" y=\""sv << position_.y << "\" "sv;
-        out << "dx=\""sv << offset_.x << "\" dy=\""sv << offset_.y << "\" "sv;
-        out << "font-size=\""sv << font_size_ << "\"";
+// ---------- Document ------------------
+
+    namespace {
 
-        if (!font_family_.empty()) {
-            out << " font-family=\""sv << font_family_ << "\"";
+        size_t Combine(size_t seed, size_t value) {
+            return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
         }
-        if (!font_weight_.empty()) {
-            out << " font-weight=\""sv << font_weight_ << "\"";
+
+        size_t HashColor(const std::optional<Color>& color) {
+            if (!color) {
+                return 0;
+            }
+            size_t hash = color->index() + 1;
+            if (const auto* name = std::get_if<std::string>(&*color)) {
+                hash = Combine(hash, std::hash<std::string>{}(*name));
+            } else if (const auto* rgb = std::get_if<Rgb>(&*color)) {
+                hash = Combine(hash, size_t{rgb->red} << 16 | size_t{rgb->green} << 8 | rgb->blue);
+            } else if (const auto* rgba = std::get_if<Rgba>(&*color)) {
+                hash = Combine(hash, size_t{rgba->red} << 16 | size_t{rgba->green} << 8 | rgba->blue);
+                hash = Combine(hash, std::hash<double>{}(rgba->opacity));
+            }
+            return hash;
         }
 
-        RenderAttrs(context.out);
-        out << ">"sv;
-        out << EscapeText(data_);
-        out << "</text>"sv;
+        // Атрибуты набора PathStyle в том виде, в каком они идут в теге
+        std::string RenderStyle(const PathStyle& style) {
+            std::ostringstream text;
+            Writer out(text);
+            if (style.fill_color) {
+                out << " fill=\""sv << *style.fill_color << '"';
+            }
+            if (style.stroke_color) {
+                out << " stroke=\""sv << *style.stroke_color << '"';
+            }
+            if (style.stroke_line_cap) {
+                out << " stroke-linecap=\""sv << *style.stroke_line_cap << '"';
+            }
+            if (style.stroke_line_join) {
+                out << " stroke-linejoin=\""sv << *style.stroke_line_join << '"';
+            }
+            if (style.stroke_width) {
+                out << " stroke-width=\""sv << *style.stroke_width << '"';
+            }
+            out.Flush();
+            return std::move(text).str();
+        }
+
+    } // namespace
+
+    size_t Document::PathStyleHasher::operator()(const PathStyle& style) const {
+        size_t hash = Combine(HashColor(style.fill_color), HashColor(style.stroke_color));
+        hash = Combine(hash, style.stroke_line_cap ? static_cast<size_t>(*style.stroke_line_cap) + 1 : 0);
+        hash = Combine(hash, style.stroke_line_join ? static_cast<size_t>(*style.stroke_line_join) + 1 : 0);
+        return Combine(hash, style.stroke_width ? std::hash<double>{}(*style.stroke_width) : 0);
     }
 
+    uint32_t Document::InternStyle(const PathStyle& style) {
+        if (const auto it = style_ids_.find(style); it != style_ids_.end()) {
+            return it->second;
+        }
+        const auto id = static_cast<uint32_t>(styles_.size());
+        styles_.push_back(style);
+        style_ids_.emplace(style, id);
+        return id;
+    }
 
-    std::string Text::EscapeText(const std::string& data) {
-        std::string result;
-        for (char c : data) {
-            switch (c) {
-                case '\"': result += "&quot;"; break;
-                case '\'': result += "&apos;"; break;
-                case '<':  result += "&lt;"; break;
-                case '>':  result += "&gt;"; break;
-                case '&':  result += "&amp;"; break;
-                default:   result += c;
+    uint32_t Document::InternFont(const std::string& family, const std::string& weight) {
+        // Шрифтов в документе единицы, поиск перебором быстрее хеш-таблицы
+        for (uint32_t i = 0; i < fonts_.size(); ++i) {
+            if (fonts_[i].family == family && fonts_[i].weight == weight) {
+                return i;
             }
         }
-        return result;
+        fonts_.push_back({family, weight});
+        return static_cast<uint32_t>(fonts_.size() - 1);
     }
 
-// ---------- Document ------------------
+    void Document::Add(const Circle& circle) {
+        items_.push_back({Kind::CIRCLE, static_cast<uint32_t>(circles_.size())});
+        circles_.push_back({circle.center_, circle.radius_, InternStyle(circle.GetPathStyle())});
+    }
 
-    void Document::AddPtr(std::unique_ptr<Object>&& object_ptr) {
-        if (object_ptr) {
-            objects_.push_back(std::move(object_ptr));
-        }
+    void Document::Add(const Polyline& polyline) {
+        items_.push_back({Kind::POLYLINE, static_cast<uint32_t>(polylines_.size())});
+        polylines_.push_back({static_cast<uint32_t>(points_.size()), static_cast<uint32_t>(polyline.points_.size()),
+                              InternStyle(polyline.GetPathStyle())});
+        points_.insert(points_.end(), polyline.points_.begin(), polyline.points_.end());
+    }
+
+    void Document::Add(const Text& text) {
+        items_.push_back({Kind::TEXT, static_cast<uint32_t>(texts_.size())});
+        texts_.push_back({text.position_, text.offset_, text.font_size_, InternFont(text.font_family_, text.font_weight_),
+                          InternStyle(text.GetPathStyle()), static_cast<uint32_t>(text_data_.size()),
+                          static_cast<uint32_t>(text.data_.size())});
+        text_data_ += text.data_;
     }
 
     void Document::Render(std::ostream& out) const {
-        RenderContext ctx(out, 2);
-        out << R"(<?xml version="1.0" encoding="UTF-8" ?>)"sv << std::endl;
-        out << R"(<svg xmlns="http://www.w3.org/2000/svg" version="1.1">)"sv << std::endl;
-        for (const auto& obj : objects_) {
-            obj->Render(ctx);
-        }
+        Writer writer(out);
+        Render(writer);
+    }
+
+    void Document::Render(Writer& out) const {
+        RenderBegin(out);
+        RenderObjects(out);
+        RenderEnd(out);
+    }
+
+    void Document::RenderBegin(Writer& out) {
+        out << R"(<?xml version="1.0" encoding="UTF-8" ?>)"sv << '\n';
+        out << R"(<svg xmlns="http://www.w3.org/2000/svg" version="1.1">)"sv << '\n';
+    }
+
+    void Document::RenderEnd(Writer& out) {
         out << "</svg>"sv;
     }
 
-}  // namespace transport_catalogue::svg
\ No newline at end of file
+    void Document::RenderObjects(Writer& out) const {
+        // Атрибуты каждого набора и шрифта форматируются один раз на весь документ
+        std::vector<std::string> styles;
+        styles.reserve(styles_.size());
+        for (const PathStyle& style : styles_) {
+            styles.push_back(RenderStyle(style));
+        }
+
+        for (const Item& item : items_) {
+            switch (item.kind) {
+                case Kind::CIRCLE: {
+                    const CircleRecord& circle = circles_[item.index];
+                    out << "<circle cx=\""sv << circle.center.x << "\" cy=\""sv << circle.center.y << "\" "sv;
+                    out << "r=\""sv << circle.radius << "\" "sv;
+                    out << styles[circle.style];
+                    out << "/>"sv;
+                    break;
+                }
+                case Kind::POLYLINE: {
+                    const PolylineRecord& polyline = polylines_[item.index];
+                    out << "<polyline points=\""sv;
+                    for (uint32_t i = 0; i < polyline.point_count; ++i) {
+                        const Point& point = points_[polyline.first_point + i];
+                        if (i > 0) out << ' ';
+                        out << point.x << ',' << point.y;
+                    }
+                    out << '"';
+                    out << styles[polyline.style];
+                    out << "/>"sv;
+                    break;
+                }
+                case Kind::TEXT: {
+                    const TextRecord& text = texts_[item.index];
+                    const Font& font = fonts_[text.font];
+                    out << "<text x=\""sv << text.position.x << "\" y=\""sv << text.position.y << "\" "sv;
+                    out << "dx=\""sv << text.offset.x << "\" dy=\""sv << text.offset.y << "\" "sv;
+                    out << "font-size=\""sv << text.font_size << '"';
+                    if (!font.family.empty()) {
+                        out << " font-family=\""sv << font.family << '"';
+                    }
+                    if (!font.weight.empty()) {
+                        out << " font-weight=\""sv << font.weight << '"';
+                    }
+                    out << styles[text.style];
+                    out << '>';
+                    out.WriteEscaped(std::string_view(text_data_).substr(text.data_offset, text.data_size));
+                    out << "</text>"sv;
+                    break;
+                }
+            }
+            out << '\n';
+        }
+    }
+
+}  // namespace transport_catalogue::svg
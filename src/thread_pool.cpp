@@ -0,0 +1,103 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace transport_catalogue {
+
+    // The pool whose loop the current thread is running a body of, if any
+    static thread_local const ThreadPool* running_pool = nullptr;
+
+    ThreadPool::ThreadPool(size_t thread_count) {
+        if (thread_count == 0) {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+        workers_.reserve(thread_count - 1);
+        for (size_t i = 1; i < thread_count; ++i) {
+            workers_.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        work_ready_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+        if (count == 0) {
+            return;
+        }
+        // A loop inside a body could not start until the outer loop ends, so it runs right here
+        if (workers_.empty() || running_pool == this) {
+            for (size_t i = 0; i < count; ++i) {
+                body(i);
+            }
+            return;
+        }
+
+        {
+            std::unique_lock lock(mutex_);
+            // A worker that woke up too late for the previous loop may still be leaving it
+            work_done_.wait(lock, [this] { return busy_workers_ == 0; });
+            body_ = &body;
+            count_ = count;
+            next_index_.store(0);
+            error_ = nullptr;
+            ++generation_;
+        }
+        work_ready_.notify_all();
+        RunIndices();
+
+        std::unique_lock lock(mutex_);
+        work_done_.wait(lock, [this] { return busy_workers_ == 0; });
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+    void ThreadPool::WorkerLoop() {
+        size_t seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                work_ready_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+                if (stopping_) {
+                    return;
+                }
+                seen_generation = generation_;
+                ++busy_workers_;
+            }
+            RunIndices();
+            {
+                std::lock_guard lock(mutex_);
+                if (--busy_workers_ == 0) {
+                    work_done_.notify_all();
+                }
+            }
+        }
+    }
+
+    void ThreadPool::RunIndices() {
+        const ThreadPool* const outer = std::exchange(running_pool, this);
+        for (size_t i; (i = next_index_.fetch_add(1)) < count_;) {
+            try {
+                (*body_)(i);
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+                // Nothing new starts once a call has failed
+                next_index_.store(count_);
+            }
+        }
+        running_pool = outer;
+    }
+
+} // namespace transport_catalogue
@@ -1,35 +1,62 @@
 #include "transport_catalogue.h"
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <vector>
-#include <unordered_set>
 #include <cmath>
 
 namespace transport_catalogue {
 
+    uint64_t TransportCatalogue::NextVersion() {
+        static std::atomic<uint64_t> last_version = 0;
+        return ++last_version;
+    }
+
     void TransportCatalogue::AddStop(std::string_view name, const geo::Coordinates& coordinates) {
-        stops_.emplace_back(Stop{std::string(name), coordinates});
+        ThawNames();
+        version_ = NextVersion();
+        const auto id = static_cast<StopId>(stops_.size());
+        stops_.emplace_back(Stop{std::string(name), coordinates, id});
         stops_index_[stops_.back().name] = &stops_.back();
+        stop_coordinates_.push_back(coordinates);
+        stop_points_.Add(coordinates);
+        stop_to_buses_.emplace_back();
+        spatial_index_ = {};
     }
 
     [[nodiscard]] const Stop* TransportCatalogue::FindStop(std::string_view name) const {
+        if (names_frozen_) {
+            const StopId id = stops_names_.Find(name);
+            return id != INVALID_ID && stops_[id].name == name ? &stops_[id] : nullptr;
+        }
         auto it = stops_index_.find(name);
         return it != stops_index_.end() ? it->second : nullptr;
     }
 
     void TransportCatalogue::AddBus(std::string_view name, const std::vector<const Stop*>& stops, bool is_roundtrip) {
-        buses_.emplace_back(Bus{std::string(name), stops, is_roundtrip});
+        ThawNames();
+        version_ = NextVersion();
+        const auto id = static_cast<BusId>(buses_.size());
+        buses_.emplace_back(Bus{std::string(name), stops, is_roundtrip, id});
         buses_index_[buses_.back().name] = &buses_.back();
 
         const Bus* bus_ptr = &buses_.back();
         for (const Stop* stop : stops) {
-            if (stop) {
-                stop_to_buses_[stop].insert(bus_ptr);
+            if (OwnsStop(stop)) {
+                AddBusToStop(stop_to_buses_[stop->id], bus_ptr);
+                route_stops_.push_back(stop->id);
             }
         }
+        route_offsets_.push_back(static_cast<uint32_t>(route_stops_.size()));
+        bus_infos_.clear();
     }
 
     [[nodiscard]] const Bus* TransportCatalogue::FindBus(std::string_view name) const {
+        if (names_frozen_) {
+            const BusId id = buses_names_.Find(name);
+            return id != INVALID_ID && buses_[id].name == name ? &buses_[id] : nullptr;
+        }
         auto it = buses_index_.find(name);
         return it != buses_index_.end() ? it->second : nullptr;
     }
@@ -39,35 +66,47 @@ namespace transport_catalogue {
         if (!bus) {
             return std::nullopt;
         }
+        if (!bus_infos_.empty()) {
+            return bus_infos_[bus->id];
+        }
+        return ComputeBusInfo(*bus);
+    }
 
-        const size_t n = bus->stops.size();
+    BusInfo TransportCatalogue::ComputeBusInfo(const Bus& bus) const {
+        const auto route = GetRoute(bus.id);
+        const size_t n = route.size();
         if (n == 0) {
             return  BusInfo {0, 0, 0.0};
         }
 
         BusInfo info;
-        const auto& stops = bus->stops;
-        info.stops_count = bus->is_roundtrip ? n : (n * 2 - 1);
-        info.unique_stops_count = std::unordered_set<const Stop*>(stops.begin(), stops.end()).size();
+        info.stops_count = bus.is_roundtrip ? n : (n * 2 - 1);
+
+        std::vector<StopId> unique_ids(route.begin(), route.end());
+        std::sort(unique_ids.begin(), unique_ids.end());
+        info.unique_stops_count = std::unique(unique_ids.begin(), unique_ids.end()) - unique_ids.begin();
 
         double road_len = 0.0;
         for (size_t i = 1; i < n; ++i) {
-            road_len += GetDistance(stops[i - 1], stops[i]);
+            road_len += GetDistance(route[i - 1], route[i]);
         }
-        if (!bus->is_roundtrip) {
+        if (!bus.is_roundtrip) {
             for (size_t i = n; i-- > 1; ) {
-                road_len += GetDistance(stops[i], stops[i - 1]);
+                road_len += GetDistance(route[i], route[i - 1]);
             }
         }
         info.route_length = road_len;
 
+        // Geographic length is symmetric, so the way back reuses the segments of the way there
+        std::vector<double> segments(n - 1);
+        geo::ComputeDistances(stop_points_, route.first(n - 1), route.subspan(1), segments);
         double geo_len = 0.0;
-        for (size_t i = 1; i < n; ++i) {
-            geo_len += geo::ComputeDistance(stops[i - 1]->coordinates, stops[i]->coordinates);
+        for (const double segment : segments) {
+            geo_len += segment;
         }
-        if (!bus->is_roundtrip) {
-            for (size_t i = n; i-- > 1; ) {
-                geo_len += geo::ComputeDistance(stops[i]->coordinates, stops[i - 1]->coordinates);
+        if (!bus.is_roundtrip) {
+            for (size_t i = n - 1; i-- > 0; ) {
+                geo_len += segments[i];
             }
         }
 
@@ -76,35 +115,195 @@ namespace transport_catalogue {
         return info;
     }
 
-    [[nodiscard]] const std::unordered_set<const Bus*>& TransportCatalogue::GetBusesForStop(const Stop* stop) const {
-        auto it = stop_to_buses_.find(stop);
-        if (it != stop_to_buses_.end()) {
-            return it->second;
+    [[nodiscard]] std::span<const Bus* const> TransportCatalogue::GetBusesForStop(const Stop* stop) const {
+        if (OwnsStop(stop)) {
+            return stop_to_buses_[stop->id];
+        }
+        return {};
+    }
+
+    void TransportCatalogue::AddBusToStop(std::vector<const Bus*>& buses, const Bus* bus) {
+        // Stop requests print bus names in order, so the list is kept sorted as it grows
+        const auto it = std::lower_bound(buses.begin(), buses.end(), bus, [](const Bus* lhs, const Bus* rhs) {
+            return lhs->name < rhs->name;
+        });
+        if (it == buses.end() || (*it)->name != bus->name) {
+            buses.insert(it, bus);
         }
-        static const std::unordered_set<const Bus*> empty_set;
-        return empty_set;
+    }
+
+    std::span<const StopId> TransportCatalogue::GetRoute(BusId id) const {
+        const auto first = route_stops_.begin() + route_offsets_[id];
+        return {first, first + (route_offsets_[id + 1] - route_offsets_[id])};
     }
 
     void TransportCatalogue::SetDistance(const Stop* from, const Stop* to, double distance) {
-        if (from && to) {
-            distances_[{from, to}] = distance;
+        if (OwnsStop(from) && OwnsStop(to)) {
+            pending_distances_[DistanceKey(from->id, to->id)] = distance;
+            bus_infos_.clear();
+            version_ = NextVersion();
         }
     }
 
     double TransportCatalogue::GetDistance(const Stop* from, const Stop* to) const {
-        if (from && to) {
-            auto it = distances_.find({from, to});
-            if (it != distances_.end()) {
+        if (OwnsStop(from) && OwnsStop(to)) {
+            return GetDistance(from->id, to->id);
+        }
+        return 0.0; // Return 0 if distance is not set
+    }
+
+    double TransportCatalogue::GetDistance(StopId from, StopId to) const {
+        if (auto distance = FindDistance(from, to)) {
+            return *distance;
+        }
+        // If the distance is not found, check the reverse direction
+        if (auto distance = FindDistance(to, from)) {
+            return *distance;
+        }
+        return 0.0;
+    }
+
+    std::optional<double> TransportCatalogue::FindDistance(StopId from, StopId to) const {
+        if (!pending_distances_.empty()) {
+            if (auto it = pending_distances_.find(DistanceKey(from, to)); it != pending_distances_.end()) {
                 return it->second;
             }
+        }
+        if (static_cast<size_t>(from) + 1 < distance_offsets_.size()) {
+            // A stop has a handful of neighbours, so a linear scan of its row beats a binary search
+            const RoadDistance* it = distances_.data() + distance_offsets_[from];
+            const RoadDistance* last = distances_.data() + distance_offsets_[from + 1];
+            for (; it != last && it->to <= to; ++it) {
+                if (it->to == to) {
+                    return it->distance;
+                }
+            }
+        }
+        return std::nullopt;
+    }
 
-            // If the distance is not found, check the reverse direction
-            it = distances_.find({to, from});
-            if (it != distances_.end()) {
-                return it->second;
+    void TransportCatalogue::Freeze() {
+        FreezeDistances();
+        FreezeNames();
+
+        // Bus statistics depend only on routes and distances, both fixed from now on
+        if (bus_infos_.size() != buses_.size()) {
+            bus_infos_.clear();
+            bus_infos_.reserve(buses_.size());
+            for (const Bus& bus : buses_) {
+                bus_infos_.push_back(ComputeBusInfo(bus));
             }
         }
-        return 0.0; // Return 0 if distance is not set
+
+        if (spatial_index_.Size() != stops_.size()) {
+            spatial_index_ = StopSpatialIndex(stop_points_);
+        }
+    }
+
+    std::vector<StopDistance> TransportCatalogue::FindNearbyStops(geo::Coordinates center, double radius,
+                                                                  size_t limit) const {
+        std::vector<StopSpatialIndex::Neighbor> found;
+        if (spatial_index_.Size() == stops_.size()) {
+            found = spatial_index_.Find(center, radius, limit);
+        } else {
+            const geo::UnitVector from = geo::ToUnitVector(center);
+            for (StopId id = 0; id < stops_.size(); ++id) {
+                const geo::UnitVector to = stop_points_.Get(id);
+                const double dx = to.x - from.x;
+                const double dy = to.y - from.y;
+                const double dz = to.z - from.z;
+                const double distance = geo::ChordToDistance(std::sqrt(dx * dx + dy * dy + dz * dz));
+                if (distance <= radius) {
+                    found.push_back({id, distance});
+                }
+            }
+            const size_t count = std::min(limit, found.size());
+            std::partial_sort(found.begin(), found.begin() + count, found.end(),
+                              [](const auto& lhs, const auto& rhs) {
+                                  return lhs.distance < rhs.distance
+                                          || (lhs.distance == rhs.distance && lhs.id < rhs.id);
+                              });
+            found.resize(count);
+        }
+
+        std::vector<StopDistance> result;
+        result.reserve(found.size());
+        for (const auto& [id, distance] : found) {
+            result.push_back({&stops_[id], distance});
+        }
+        return result;
+    }
+
+    void TransportCatalogue::FreezeNames() {
+        if (names_frozen_) {
+            return;
+        }
+        std::vector<std::pair<std::string_view, uint32_t>> items;
+        items.reserve(stops_index_.size());
+        for (const auto& [name, stop] : stops_index_) {
+            items.emplace_back(name, stop->id);
+        }
+        stops_names_ = PerfectHashIndex(items);
+
+        items.clear();
+        for (const auto& [name, bus] : buses_index_) {
+            items.emplace_back(name, bus->id);
+        }
+        buses_names_ = PerfectHashIndex(items);
+
+        // Assigning an empty map releases the bucket array too, unlike clear()
+        stops_index_ = {};
+        buses_index_ = {};
+        names_frozen_ = true;
+    }
+
+    void TransportCatalogue::ThawNames() {
+        if (!names_frozen_) {
+            return;
+        }
+        for (const Stop& stop : stops_) {
+            stops_index_[stop.name] = &stop;
+        }
+        for (const Bus& bus : buses_) {
+            buses_index_[bus.name] = &bus;
+        }
+        stops_names_ = {};
+        buses_names_ = {};
+        names_frozen_ = false;
+    }
+
+    void TransportCatalogue::FreezeDistances() {
+        if (pending_distances_.empty() && distance_offsets_.size() == stops_.size() + 1) {
+            return;
+        }
+
+        // Distances already frozen, overridden by the ones set since then
+        std::vector<std::pair<uint64_t, double>> all;
+        all.reserve(distances_.size() + pending_distances_.size());
+        for (const auto& [key, distance] : pending_distances_) {
+            all.emplace_back(key, distance);
+        }
+        for (StopId from = 0; static_cast<size_t>(from) + 1 < distance_offsets_.size(); ++from) {
+            for (uint32_t i = distance_offsets_[from]; i < distance_offsets_[from + 1]; ++i) {
+                const uint64_t key = DistanceKey(from, distances_[i].to);
+                if (!pending_distances_.count(key)) {
+                    all.emplace_back(key, distances_[i].distance);
+                }
+            }
+        }
+        std::sort(all.begin(), all.end());
+
+        distance_offsets_.assign(stops_.size() + 1, 0);
+        distances_.clear();
+        distances_.reserve(all.size());
+        for (const auto& [key, distance] : all) {
+            ++distance_offsets_[(key >> 32) + 1];
+            distances_.push_back({static_cast<StopId>(key), distance});
+        }
+        for (size_t i = 1; i < distance_offsets_.size(); ++i) {
+            distance_offsets_[i] += distance_offsets_[i - 1];
+        }
+        pending_distances_.clear();
     }
 
 } // namespace transport_catalogue
\ No newline at end of file
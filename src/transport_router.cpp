@@ -0,0 +1,108 @@
+#include "transport_router.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace transport_catalogue::router {
+
+    TransportRouter::TransportRouter(const TransportCatalogue& db, RoutingSettings settings)
+            : db_(db), settings_(settings) {
+        if (settings_.bus_velocity <= 0.0 || settings_.bus_wait_time < 0.0) {
+            throw std::invalid_argument("TransportRouter: bus_velocity must be positive and bus_wait_time non-negative");
+        }
+        BuildGraph();
+    }
+
+    void TransportRouter::BuildGraph() {
+        // km/h -> meters per minute
+        const double meters_per_minute = settings_.bus_velocity * 1000.0 / 60.0;
+
+        std::vector<graph::Edge<double>> edges;
+        auto vertex_count = static_cast<graph::VertexId>(db_.GetStopCount());
+        std::vector<StopId> sequence;
+        for (BusId bus = 0; bus < db_.GetBusCount(); ++bus) {
+            const std::span<const StopId> route = db_.GetRoute(bus);
+            if (route.empty()) {
+                continue;
+            }
+            sequence.assign(route.begin(), route.end());
+            if (!db_.GetBus(bus).is_roundtrip) {
+                sequence.insert(sequence.end(), route.rbegin() + 1, route.rend());
+            }
+
+            const graph::VertexId first = vertex_count;
+            vertex_count += static_cast<graph::VertexId>(sequence.size());
+            for (uint32_t i = 0; i < sequence.size(); ++i) {
+                const graph::VertexId position = first + i;
+                // Nobody boards at the last stop or gets off at the first one
+                if (i + 1 < sequence.size()) {
+                    edges.push_back({sequence[i], position, settings_.bus_wait_time});
+                    edge_infos_.push_back({EdgeKind::Board, sequence[i]});
+                    const double distance = db_.GetDistance(sequence[i], sequence[i + 1]);
+                    edges.push_back({position, position + 1, distance / meters_per_minute});
+                    edge_infos_.push_back({EdgeKind::Ride, bus});
+                }
+                if (i > 0) {
+                    edges.push_back({position, sequence[i], 0.0});
+                    edge_infos_.push_back({EdgeKind::Alight, sequence[i]});
+                }
+            }
+        }
+        graph_ = graph::DirectedWeightedGraph<double>(vertex_count, std::move(edges));
+    }
+
+    std::optional<RouteInfo> TransportRouter::BuildRoute(const Stop* from, const Stop* to) const {
+        if (!from || !to || from->id >= db_.GetStopCount() || to->id >= db_.GetStopCount()) {
+            return std::nullopt;
+        }
+        const auto route = index_ ? index_->BuildRoute(graph_, from->id, to->id)
+                                  : router_.BuildRoute(from->id, to->id);
+        if (!route) {
+            return std::nullopt;
+        }
+        return MakeRouteInfo(route->weight, route->edges);
+    }
+
+    void TransportRouter::BuildIndex() {
+        index_.emplace(graph_);
+    }
+
+    void TransportRouter::SetIndex(graph::Landmarks index) {
+        if (!index.Matches(graph_)) {
+            throw std::invalid_argument("TransportRouter: the landmark index was built for another graph");
+        }
+        index_ = std::move(index);
+    }
+
+    bool TransportRouter::TrySetIndex(graph::Landmarks index) {
+        if (!index.Matches(graph_)) {
+            return false;
+        }
+        index_ = std::move(index);
+        return true;
+    }
+
+    RouteInfo TransportRouter::MakeRouteInfo(double total_time, std::span<const graph::EdgeId> edges) const {
+        RouteInfo info{total_time, {}};
+        for (const graph::EdgeId id : edges) {
+            const EdgeInfo& edge = edge_infos_[id];
+            switch (edge.kind) {
+                case EdgeKind::Board:
+                    info.items.emplace_back(WaitItem{&db_.GetStop(edge.object), graph_.GetEdge(id).weight});
+                    info.items.emplace_back(BusItem{nullptr, 0, 0.0});
+                    break;
+                case EdgeKind::Ride: {
+                    auto& ride = std::get<BusItem>(info.items.back());
+                    ride.bus = &db_.GetBus(edge.object);
+                    ++ride.span_count;
+                    ride.time += graph_.GetEdge(id).weight;
+                    break;
+                }
+                case EdgeKind::Alight:
+                    break;
+            }
+        }
+        return info;
+    }
+
+} // namespace transport_catalogue::router
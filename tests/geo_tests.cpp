@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "geo.h"
+
+using namespace transport_catalogue::geo;
+
+TEST(Geo, BatchDistancesMatchScalarWithinTolerance) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> lat(-80.0, 80.0);
+    std::uniform_real_distribution<double> lng(-180.0, 180.0);
+    std::uniform_real_distribution<double> offset(-0.5, 0.5);
+
+    std::vector<Coordinates> points;
+    std::vector<uint32_t> from;
+    std::vector<uint32_t> to;
+    // 1003 segments: the last ones go through the scalar tail of the AVX2 path
+    for (uint32_t i = 0; i < 1003; ++i) {
+        const Coordinates p{lat(rng), lng(rng)};
+        points.push_back(p);
+        points.push_back({p.lat + offset(rng), p.lng + offset(rng)});
+        from.push_back(2 * i);
+        to.push_back(2 * i + 1);
+    }
+    // Antipodal and coincident points
+    points.push_back({10.0, 20.0});
+    points.push_back({-10.0, -160.0});
+    from.insert(from.end(), {2006, 2006});
+    to.insert(to.end(), {2007, 2006});
+
+    const PointTable table(points);
+    std::vector<double> out(from.size());
+    ComputeDistances(table, from, to, out);
+
+    for (size_t i = 0; i < from.size(); ++i) {
+        const double expected = ComputeDistance(points[from[i]], points[to[i]]);
+        if (expected >= 100.0) {
+            EXPECT_NEAR(out[i], expected, expected * 1e-6) << i;
+        } else {
+            EXPECT_NEAR(out[i], expected, 1.0) << i;
+        }
+    }
+    EXPECT_NEAR(out[out.size() - 2], M_PI * 6371000, 1.0);
+    EXPECT_EQ(out.back(), 0.0);
+}
+
+TEST(Geo, BatchDistanceDoesNotDependOnPosition) {
+    const PointTable table(std::vector<Coordinates>{{55.0, 37.0}, {55.01, 37.02}});
+    // Position 0 is computed by the vector kernel (when available), position 5 by the scalar tail
+    const std::vector<uint32_t> from(6, 0);
+    const std::vector<uint32_t> to(6, 1);
+    std::vector<double> out(6);
+    ComputeDistances(table, from, to, out);
+    EXPECT_DOUBLE_EQ(out[0], out[5]);
+}
@@ -0,0 +1,303 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "json_reader.h"
+#include "map_renderer.h"
+#include "request_handler.h"
+#include "thread_pool.h"
+
+using namespace transport_catalogue;
+
+namespace {
+
+    const std::string kInput = R"({
+        "base_requests": [
+            {"type": "Bus", "name": "114", "stops": ["Морской вокзал", "Ривьерский мост"], "is_roundtrip": false},
+            {"type": "Stop", "name": "Ривьерский мост", "latitude": 43.587795, "longitude": 39.716901,
+             "road_distances": {"Морской вокзал": 850}},
+            {"type": "Stop", "name": "Морской вокзал", "latitude": 43.581969, "longitude": 39.719848,
+             "road_distances": {"Ривьерский мост": 850}},
+            {"type": "Stop", "name": "Пустая", "latitude": 43.5, "longitude": 39.7}
+        ],
+        "render_settings": {
+            "width": 200, "height": 200, "padding": 30, "stop_radius": 5, "line_width": 14,
+            "bus_label_font_size": 20, "bus_label_offset": [7, 15],
+            "stop_label_font_size": 20, "stop_label_offset": [7, -3],
+            "underlayer_color": [255, 255, 255, 0.85], "underlayer_width": 3,
+            "color_palette": ["green", [255, 160, 0], "red"]
+        },
+        "routing_settings": {"bus_wait_time": 6, "bus_velocity": 40},
+        "stat_requests": [
+            {"id": 1, "type": "Map"},
+            {"id": 2, "type": "Stop", "name": "Ривьерский мост"},
+            {"id": 3, "type": "Bus", "name": "114"},
+            {"id": 4, "type": "Stop", "name": "Пустая"},
+            {"id": 5, "type": "Bus", "name": "999"},
+            {"id": 6, "type": "NearbyStops", "latitude": 43.582, "longitude": 39.7198, "count": 2},
+            {"id": 7, "type": "NearbyStops", "latitude": 43.582, "longitude": 39.7198, "radius": 1000},
+            {"id": 8, "type": "NearbyStops", "latitude": 43.582, "longitude": 39.7198},
+            {"id": 9, "type": "Route", "from": "Морской вокзал", "to": "Ривьерский мост"},
+            {"id": 10, "type": "Route", "from": "Морской вокзал", "to": "Пустая"},
+            {"id": 11, "type": "NearbyStops", "count": 1},
+            {"id": 12, "type": "NearbyStops", "latitude": 43.582, "longitude": "39.7198", "count": 1},
+            {"id": 13, "type": "NearbyStops", "latitude": 43.582, "longitude": 39.7198, "radius": -1}
+        ]
+    })";
+
+    template <typename Reader>
+    std::string RunStatRequests(Reader&& make_reader) {
+        TransportCatalogue catalogue;
+        JsonReader reader = make_reader(catalogue);
+        reader.ProcessBaseRequests();
+        renderer::MapRenderer renderer;
+        reader.ProcessRenderSettings(renderer);
+        const router::TransportRouter router(catalogue, *reader.GetRoutingSettings());
+        RequestHandler handler(catalogue, renderer, &router);
+
+        std::ostringstream out;
+        json::Print(json::Document{json::Node{reader.ProcessStatRequests(handler)}}, out);
+        return out.str();
+    }
+
+} // namespace
+
+TEST(JsonReader, StreamingModeMatchesDocumentMode) {
+    const std::string from_document = RunStatRequests([](TransportCatalogue& db) {
+        return JsonReader(json::Load(std::string_view(kInput)), db);
+    });
+    const std::string from_stream = RunStatRequests([](TransportCatalogue& db) {
+        return JsonReader(std::string_view(kInput), db);
+    });
+    EXPECT_NE(from_document.find("\"route_length\": 1700"), std::string::npos);
+    EXPECT_NE(from_document.find("<polyline"), std::string::npos);
+    EXPECT_EQ(from_stream, from_document);
+}
+
+TEST(JsonReader, StreamingModeRejectsNonObjectRoot) {
+    TransportCatalogue catalogue;
+    EXPECT_THROW(JsonReader(std::string_view("[1, 2]"), catalogue), std::logic_error);
+}
+
+TEST(JsonReader, BothModesRejectNonArrayRequests) {
+    for (const std::string_view input : {R"({"base_requests": {"type": "Stop"}})", R"({"base_requests": 1})",
+                                         R"({"stat_requests": "Bus"})"}) {
+        TransportCatalogue from_document;
+        EXPECT_THROW(JsonReader(json::Load(input), from_document), json::ParsingError) << input;
+        TransportCatalogue from_stream;
+        EXPECT_THROW(JsonReader(input, from_stream), json::ParsingError) << input;
+    }
+}
+
+TEST(JsonReader, StreamedResponsesMatchPrintedArray) {
+    TransportCatalogue catalogue;
+    JsonReader reader(std::string_view(kInput), catalogue);
+    reader.ProcessBaseRequests();
+    renderer::MapRenderer renderer;
+    reader.ProcessRenderSettings(renderer);
+    const router::TransportRouter router(catalogue, *reader.GetRoutingSettings());
+    RequestHandler handler(catalogue, renderer, &router);
+
+    std::ostringstream printed;
+    json::Print(json::Document{json::Node{reader.ProcessStatRequests(handler)}}, printed);
+
+    std::ostringstream streamed;
+    {
+        json::Writer writer(streamed);
+        reader.ProcessStatRequests(handler, writer);
+    }
+    EXPECT_EQ(streamed.str(), printed.str());
+}
+
+TEST(JsonReader, NearbyStopsRequests) {
+    TransportCatalogue catalogue;
+    JsonReader reader(std::string_view(kInput), catalogue);
+    reader.ProcessBaseRequests();
+    renderer::MapRenderer renderer;
+    reader.ProcessRenderSettings(renderer);
+    RequestHandler handler(catalogue, renderer);
+
+    const json::Array responses = reader.ProcessStatRequests(handler);
+    auto names = [&responses](size_t index) {
+        std::vector<std::string> result;
+        for (const auto& stop : responses.at(index).AsDict().at("stops").AsArray()) {
+            result.push_back(stop.AsDict().at("name").AsString());
+        }
+        return result;
+    };
+    EXPECT_EQ(names(5), (std::vector<std::string>{"Морской вокзал", "Ривьерский мост"}));
+    EXPECT_EQ(names(6), (std::vector<std::string>{"Морской вокзал", "Ривьерский мост"}));
+    EXPECT_TRUE(names(7).empty());
+    EXPECT_EQ(responses.at(5).AsDict().at("request_id").AsInt(), 6);
+    EXPECT_LT(responses.at(5).AsDict().at("stops").AsArray().at(0).AsDict().at("distance").AsDouble(), 10.0);
+
+    // No center or a negative radius: answered like an unknown stop, not searched around (0, 0)
+    for (const size_t index : {10, 11, 12}) {
+        const auto& response = responses.at(index).AsDict();
+        EXPECT_EQ(response.at("error_message").AsString(), "not found");
+        EXPECT_EQ(response.at("request_id").AsInt(), static_cast<int>(index) + 1);
+        EXPECT_EQ(response.count("stops"), 0u);
+    }
+}
+
+TEST(JsonReader, RouteRequests) {
+    TransportCatalogue catalogue;
+    JsonReader reader(std::string_view(kInput), catalogue);
+    reader.ProcessBaseRequests();
+    renderer::MapRenderer renderer;
+    reader.ProcessRenderSettings(renderer);
+    const auto settings = reader.GetRoutingSettings();
+    ASSERT_TRUE(settings);
+    const router::TransportRouter router(catalogue, *settings);
+    RequestHandler handler(catalogue, renderer, &router);
+
+    const json::Array responses = reader.ProcessStatRequests(handler);
+    // 850 m at 40 km/h after a 6 minute wait
+    const auto& route = responses.at(8).AsDict();
+    EXPECT_DOUBLE_EQ(route.at("total_time").AsDouble(), 6.0 + 850.0 / (40.0 * 1000.0 / 60.0));
+    const auto& items = route.at("items").AsArray();
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(items[0].AsDict().at("type").AsString(), "Wait");
+    EXPECT_EQ(items[0].AsDict().at("stop_name").AsString(), "Морской вокзал");
+    EXPECT_EQ(items[1].AsDict().at("bus").AsString(), "114");
+    EXPECT_EQ(items[1].AsDict().at("span_count").AsInt(), 1);
+    EXPECT_EQ(responses.at(9).AsDict().at("error_message").AsString(), "not found");
+}
+
+TEST(JsonReader, ParallelModeKeepsRequestOrder) {
+    TransportCatalogue catalogue;
+    JsonReader reader(std::string_view(kInput), catalogue);
+    reader.ProcessBaseRequests();
+    renderer::MapRenderer renderer;
+    reader.ProcessRenderSettings(renderer);
+    const router::TransportRouter router(catalogue, *reader.GetRoutingSettings());
+    RequestHandler handler(catalogue, renderer, &router);
+
+    auto stream = [&](ThreadPool* pool) {
+        std::ostringstream out;
+        json::Writer writer(out);
+        reader.ProcessStatRequests(handler, writer, pool);
+        return out.str();
+    };
+    const std::string serial = stream(nullptr);
+    // More threads than requests as well as fewer
+    for (const size_t threads : {1u, 3u, 16u}) {
+        ThreadPool pool(threads);
+        EXPECT_EQ(stream(&pool), serial) << threads << " threads";
+        EXPECT_EQ(reader.ProcessStatRequests(handler, &pool), reader.ProcessStatRequests(handler));
+    }
+}
+
+TEST(JsonReader, MapIsRenderedOncePerCatalogueAndSettings) {
+    TransportCatalogue catalogue;
+    JsonReader reader(std::string_view(kInput), catalogue);
+    reader.ProcessBaseRequests();
+    renderer::MapRenderer renderer;
+    reader.ProcessRenderSettings(renderer);
+    RequestHandler handler(catalogue, renderer);
+
+    // The text is formatted once: every caller gets the very same string
+    const auto svg = renderer.RenderSvgText(catalogue);
+    ASSERT_TRUE(svg);
+    std::ostringstream rendered;
+    handler.RenderMap().Render(rendered);
+    EXPECT_EQ(*svg, rendered.str());
+    std::ostringstream streamed;
+    handler.RenderMapSvg(streamed);
+    EXPECT_EQ(streamed.str(), rendered.str());
+    EXPECT_EQ(renderer.RenderSvgText(catalogue), svg);
+
+    // Answers as Node trees and as streamed text carry the same map and format nothing anew
+    const json::Array responses = reader.ProcessStatRequests(handler);
+    EXPECT_EQ(responses.at(0).AsDict().at("map").AsString(), rendered.str());
+    std::ostringstream text;
+    {
+        json::Writer writer(text);
+        reader.ProcessStatRequests(handler, writer);
+    }
+    EXPECT_EQ(json::Load(std::string_view(text.str())).GetRoot().AsArray().at(0), responses.at(0));
+    EXPECT_EQ(renderer.RenderSvgText(catalogue), svg);
+
+    // Any change of the catalogue or of the settings renders and formats the map anew
+    const uint64_t version = catalogue.GetVersion();
+    catalogue.AddStop("Новая", {43.59, 39.72});
+    EXPECT_NE(catalogue.GetVersion(), version);
+    const auto after_change = renderer.RenderSvgText(catalogue);
+    EXPECT_NE(after_change, svg);
+    EXPECT_EQ(*after_change, *svg);  // the new stop has no buses and is not drawn
+
+    renderer::RenderSettings settings;
+    settings.width = 100;
+    settings.color_palette = {svg::Color{"red"}};
+    renderer.SetSettings(settings);
+    EXPECT_NE(renderer.RenderSvgText(catalogue), after_change);
+
+    // Versions are unique across catalogues
+    EXPECT_NE(TransportCatalogue().GetVersion(), TransportCatalogue().GetVersion());
+}
+
+TEST(JsonReader, MapRenderedInParallelMatchesSerial) {
+    // Enough stops and buses for every layer to be cut into several parts
+    TransportCatalogue catalogue;
+    const size_t stop_count = renderer::MapRenderer::CHUNK_SIZE * 3 + 17;
+    std::vector<const Stop*> stops;
+    for (size_t i = 0; i < stop_count; ++i) {
+        const double angle = static_cast<double>(i) * 0.37;
+        catalogue.AddStop("Остановка <" + std::to_string(i) + ">",
+                          {43.5 + 0.1 * std::sin(angle), 39.7 + 0.1 * std::cos(angle * 1.3)});
+        stops.push_back(catalogue.FindStop("Остановка <" + std::to_string(i) + ">"));
+    }
+    for (size_t i = 0; i + 2 < stop_count; ++i) {
+        catalogue.AddBus(std::to_string(i), {stops[i], stops[i + 1], stops[(i * 7) % stop_count]}, i % 3 == 0);
+    }
+    catalogue.Freeze();
+
+    renderer::RenderSettings settings;
+    settings.width = 1200;
+    settings.height = 800;
+    settings.padding = 50;
+    settings.line_width = 14;
+    settings.stop_radius = 5;
+    settings.bus_label_font_size = 20;
+    settings.stop_label_font_size = 18;
+    settings.underlayer_color = svg::Rgba{255, 255, 255, 0.85};
+    settings.underlayer_width = 3;
+    settings.color_palette = {svg::Color{"green"}, svg::Rgb{255, 160, 0}, svg::Color{"red"}};
+
+    renderer::MapRenderer serial;
+    serial.SetSettings(settings);
+    std::ostringstream expected;
+    serial.Render(catalogue).Render(expected);
+    std::ostringstream streamed;
+    serial.RenderSvg(catalogue, streamed);
+    EXPECT_EQ(streamed.str(), expected.str());
+
+    for (const size_t threads : {2u, 5u}) {
+        ThreadPool pool(threads);
+        renderer::MapRenderer parallel;
+        parallel.SetSettings(settings);
+        parallel.SetThreadPool(&pool);
+        std::ostringstream text;
+        parallel.RenderSvg(catalogue, text);
+        EXPECT_EQ(text.str(), expected.str()) << threads << " threads";
+
+        // Map answers among others, with the renderer sharing the pool of the stat requests
+        RequestHandler handler(catalogue, parallel);
+        const std::string input = R"({"base_requests": [], "stat_requests": [
+            {"id": 1, "type": "Bus", "name": "5"}, {"id": 2, "type": "Map"}, {"id": 3, "type": "Map"},
+            {"id": 4, "type": "Stop", "name": "Остановка <3>"}]})";
+        TransportCatalogue unused;
+        JsonReader reader{std::string_view(input), unused};
+        const auto stream = [&](ThreadPool* stat_pool) {
+            std::ostringstream out;
+            json::Writer writer(out);
+            reader.ProcessStatRequests(handler, writer, stat_pool);
+            return out.str();
+        };
+        EXPECT_EQ(stream(&pool), stream(nullptr));
+        EXPECT_EQ(reader.ProcessStatRequests(handler, &pool), reader.ProcessStatRequests(handler));
+    }
+}
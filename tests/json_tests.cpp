@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "json.h"
+#include "json_builder.h"
+
+using namespace std::literals;
+
+namespace {
+
+    json::Document LoadFromStream(const std::string& text) {
+        std::istringstream in(text);
+        return json::Load(in);
+    }
+
+    // Возвращает сообщение ParsingError или пустую строку, если разбор прошёл успешно
+    template <typename Loader>
+    std::string ParsingErrorOf(Loader loader) {
+        try {
+            loader();
+        } catch (const json::ParsingError& e) {
+            return e.what();
+        }
+        return {};
+    }
+
+} // namespace
+
+TEST(JsonLoad, BufferMatchesStreamOnValidInput) {
+    const std::string inputs[] = {
+            "null"s,
+            "  true "s,
+            "false"s,
+            "42"s,
+            "-0"s,
+            "3.25e-2"s,
+            "12345678901234"s,
+            R"("line\nwith \"escapes\" \\ and \t tabs")"s,
+            "[]"s,
+            "[1, 2.5, \"x\", [null], {}]"s,
+            R"({"b": {"c": [1, 2, 3]}, "a": "Остановка", "z": -1E3})"s,
+            "[1 2 3]"s,
+            "{\"a\": 1 \"b\": 2}"s,
+            "\n\t{ \"k\" : [ true , false ] }\r\n"s,
+    };
+    for (const auto& text : inputs) {
+        EXPECT_EQ(json::Load(std::string_view(text)), LoadFromStream(text)) << text;
+        EXPECT_EQ(json::Load(text, {json::ScanMode::Structural}), LoadFromStream(text)) << text;
+    }
+}
+
+TEST(JsonLoad, BufferReportsSameErrorsAsStream) {
+    const std::string inputs[] = {
+            ""s,
+            "["s,
+            "[1, 2"s,
+            "{\"a\" 1}"s,
+            "{\"a\": 1, \"a\": 2}"s,
+            "{\"a\": 1"s,
+            "\"unterminated"s,
+            "\"bad \\q escape\""s,
+            "\"multi\nline\""s,
+            "tru"s,
+            "nul"s,
+            "-"s,
+            "1."s,
+            "1e"s,
+            "}"s,
+            "1e999"s,
+    };
+    for (const auto& text : inputs) {
+        const auto stream_error = ParsingErrorOf([&] { LoadFromStream(text); });
+        const auto buffer_error = ParsingErrorOf([&] { json::Load(std::string_view(text)); });
+        const auto indexed_error = ParsingErrorOf([&] { json::Load(text, {json::ScanMode::Structural}); });
+        EXPECT_FALSE(stream_error.empty()) << text;
+        EXPECT_EQ(buffer_error, stream_error) << text;
+        EXPECT_EQ(indexed_error, stream_error) << text;
+    }
+}
+
+TEST(JsonLoad, StructuralScanMatchesScalarOnLongStrings) {
+    // Строки длиннее векторного блока, со спецсимволами на границах блоков
+    std::string text = "[";
+    for (int i = 0; i < 200; ++i) {
+        std::string name(static_cast<size_t>(i % 70), 'a' + static_cast<char>(i % 26));
+        name.insert(name.size() / 2, i % 3 == 0 ? "\\\"" : "{,}: []");
+        text += "\"" + name + "\", " + std::to_string(i * 1.5) + ", {\"k" + std::to_string(i) + "\": \"" + name + "\"},\n";
+    }
+    text += "null]";
+
+    const auto scalar = json::Load(text, {json::ScanMode::Scalar});
+    EXPECT_EQ(json::Load(text, {json::ScanMode::Structural}), scalar);
+    EXPECT_EQ(LoadFromStream(text), scalar);
+
+    for (size_t cut = 1; cut < text.size(); cut += 37) {
+        const std::string truncated = text.substr(0, cut);
+        EXPECT_EQ(ParsingErrorOf([&] { json::Load(truncated, {json::ScanMode::Structural}); }),
+                  ParsingErrorOf([&] { json::Load(truncated, {json::ScanMode::Scalar}); })) << cut;
+    }
+}
+
+TEST(JsonParse, NodeBuilderRebuildsLoadedDocument) {
+    const std::string text = R"({"b": {"c": [1, 2.5, "x\ty"]}, "a": [true, false, null], "e": {}})";
+    json::NodeBuilder builder;
+    json::Parse(text, builder);
+    ASSERT_TRUE(builder.HasValue());
+    EXPECT_EQ(json::Document(builder.Extract()), json::Load(std::string_view(text)));
+}
+
+TEST(JsonParse, NodeBuilderRejectsDuplicateKeys) {
+    json::NodeBuilder builder;
+    EXPECT_THROW(json::Parse(R"({"a": 1, "a": 2})", builder), json::ParsingError);
+}
+
+TEST(JsonLoad, ArenaDocumentMatchesHeapDocument) {
+    const std::string text = R"({"stops": [{"name": "A long stop name that does not fit SSO", "distances": {"B": 1, "C": 2}}],
+                                 "empty": [], "nested": [[1, [2, [3]]], {"k": {"k": {}}}]})";
+    json::Document heap = json::Load(std::string_view(text));
+    json::Document arena = json::Load(text, {json::ScanMode::Scalar, true});
+    EXPECT_FALSE(heap.HasArena());
+    EXPECT_TRUE(arena.HasArena());
+    EXPECT_EQ(arena, heap);
+
+    // Копия живёт независимо от арены исходного документа
+    std::optional<json::Document> source = json::Load(text, {json::ScanMode::Structural, true});
+    json::Document copy = *source;
+    source.reset();
+    EXPECT_FALSE(copy.HasArena());
+    EXPECT_EQ(copy, heap);
+}
+
+TEST(JsonDict, KeepsKeysSortedAndFindsByStringView) {
+    json::Dict dict;
+    EXPECT_TRUE(dict.emplace("type", "Bus"s).second);
+    EXPECT_TRUE(dict.emplace("id", 1).second);
+    EXPECT_TRUE(dict.emplace("name", "14"s).second);
+    EXPECT_FALSE(dict.emplace("id", 2).second);
+
+    ASSERT_EQ(dict.size(), 3u);
+    EXPECT_EQ(dict.at("id"sv).AsInt(), 1);
+    EXPECT_EQ(dict.find("name"sv)->second.AsString(), "14");
+    EXPECT_EQ(dict.find("nope"sv), dict.end());
+    EXPECT_TRUE(dict.contains("type"));
+    EXPECT_THROW((void)dict.at("nope"), std::out_of_range);
+
+    std::string keys;
+    for (const auto& [key, value] : dict) {
+        keys += key + ' ';
+    }
+    EXPECT_EQ(keys, "id name type ");
+
+    std::ostringstream out;
+    json::Print(json::Document{json::Node{dict}}, out);
+    EXPECT_EQ(out.str(), "{\n    \"id\": 1,\n    \"name\": \"14\",\n    \"type\": \"Bus\"\n}");
+    EXPECT_EQ(dict, (json::Dict{{"type", "Bus"s}, {"name", "14"s}, {"id", 1}}));
+}
+
+TEST(JsonNumbers, IntOverflowBecomesDoubleAndDoublesRoundTrip) {
+    const auto doc = json::Load("[2147483647, 2147483648, -2147483649, 0.1, 1e21, 55.611087]"sv);
+    const auto& arr = doc.GetRoot().AsArray();
+    EXPECT_TRUE(arr[0].IsInt());
+    EXPECT_TRUE(arr[1].IsPureDouble());
+    EXPECT_DOUBLE_EQ(arr[1].AsDouble(), 2147483648.0);
+    EXPECT_TRUE(arr[2].IsPureDouble());
+
+    std::ostringstream out;
+    json::Print(doc, out);
+    EXPECT_NE(out.str().find("55.611087"), std::string::npos);
+    EXPECT_NE(out.str().find("0.1,"), std::string::npos);
+    EXPECT_EQ(json::Load(std::string_view(out.str())), doc);
+
+    const double curvature = 1.0 / 3.0;
+    std::ostringstream printed;
+    json::Print(json::Document{json::Node{curvature}}, printed);
+    EXPECT_EQ(json::Load(std::string_view(printed.str())).GetRoot().AsDouble(), curvature);
+}
+
+TEST(JsonPrint, CompactAndPrettyOutput) {
+    const auto doc = json::Load(R"({"b": [1, "a\"b", {}], "a": null, "c": [], "d": {"e": true}})"sv);
+
+    std::ostringstream compact;
+    json::Print(doc, compact, {true});
+    EXPECT_EQ(compact.str(), R"({"a":null,"b":[1,"a\"b",{}],"c":[],"d":{"e":true}})");
+
+    std::ostringstream pretty;
+    json::Print(doc, pretty);
+    EXPECT_EQ(pretty.str(), "{\n"
+                            "    \"a\": null,\n"
+                            "    \"b\": [\n"
+                            "        1,\n"
+                            "        \"a\\\"b\",\n"
+                            "        {\n"
+                            "\n"
+                            "        }\n"
+                            "    ],\n"
+                            "    \"c\": [\n"
+                            "\n"
+                            "    ],\n"
+                            "    \"d\": {\n"
+                            "        \"e\": true\n"
+                            "    }\n"
+                            "}");
+    EXPECT_EQ(json::Load(std::string_view(compact.str())), doc);
+}
+
+TEST(JsonPrint, StreamedStringIsEscapedLikeWholeString) {
+    // Больше буфера писателя, с экранируемыми символами на стыках кусков
+    std::string text;
+    for (int i = 0; i < 20000; ++i) {
+        text += "<a x=\"1\">\\\n\t";
+    }
+
+    std::ostringstream whole;
+    {
+        json::Writer writer(whole);
+        writer.StartArray();
+        writer.Value(text);
+        writer.Value(1);
+        writer.EndArray();
+    }
+
+    std::ostringstream streamed;
+    {
+        json::Writer writer(streamed);
+        json::TextBuilder builder(writer);
+        builder.StartArray()
+                    .Value(json::StreamedString{[&text](std::ostream& out) {
+                        for (size_t pos = 0; pos < text.size(); pos += 7) {
+                            out << std::string_view(text).substr(pos, 7);
+                        }
+                        out.put('"');
+                    }})
+                    .Value(1)
+                .EndArray()
+                .Build();
+    }
+    EXPECT_EQ(json::Load(std::string_view(streamed.str())).GetRoot().AsArray().at(0).AsString(), text + '"');
+    EXPECT_EQ(streamed.str().size(), whole.str().size() + 2);
+}
+
+TEST(JsonTextBuilder, WritesSameTextAsBuilder) {
+    const auto tree = json::Builder{}
+            .StartDict()
+                .Key("a").StartArray().Value(1).Value("x").StartDict().EndDict().EndArray()
+                .Key("b").Value(nullptr)
+                .Key("c").Value(json::Array{json::Node{2.5}})
+            .EndDict()
+            .Build();
+    std::ostringstream printed;
+    json::Print(json::Document{tree}, printed);
+
+    std::ostringstream text;
+    {
+        json::Writer writer(text);
+        json::TextBuilder builder(writer);
+        builder.StartDict()
+                    .Key("a").StartArray().Value(1).Value("x").StartDict().EndDict().EndArray()
+                    .Key("b").Value(nullptr)
+                    .Key("c").Value(json::Node{json::Array{json::Node{2.5}}})
+                .EndDict()
+                .Build();
+    }
+    EXPECT_EQ(text.str(), printed.str());
+}
+
+TEST(JsonTextBuilder, RejectsMisuseLikeBuilder) {
+    std::ostringstream out;
+    json::Writer writer(out);
+    {
+        json::TextBuilder builder(writer);
+        EXPECT_THROW(builder.Build(), std::logic_error);
+    }
+    {
+        json::TextBuilder builder(writer);
+        builder.StartArray();
+        EXPECT_THROW(builder.Key("k"), std::logic_error);
+        EXPECT_THROW(builder.Build(), std::logic_error);
+    }
+    {
+        json::TextBuilder builder(writer);
+        auto dict = builder.StartDict();
+        EXPECT_THROW(builder.Value(1), std::logic_error);
+        dict.Key("k");
+        EXPECT_THROW(builder.Key("j"), std::logic_error);
+    }
+    {
+        json::TextBuilder builder(writer);
+        builder.Value(1).Build();
+        EXPECT_THROW(builder.StartArray(), std::logic_error);
+    }
+}
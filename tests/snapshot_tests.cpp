@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json_reader.h"
+#include "map_renderer.h"
+#include "request_handler.h"
+#include "snapshot.h"
+#include "transport_router.h"
+
+using namespace transport_catalogue;
+
+namespace {
+
+    const std::string kInput = R"({
+        "base_requests": [
+            {"type": "Bus", "name": "114", "stops": ["Морской вокзал", "Ривьерский мост"], "is_roundtrip": false},
+            {"type": "Bus", "name": "24", "stops": ["Пустая", "Морской вокзал", "Пустая"], "is_roundtrip": true},
+            {"type": "Stop", "name": "Ривьерский мост", "latitude": 43.587795, "longitude": 39.716901,
+             "road_distances": {"Морской вокзал": 850}},
+            {"type": "Stop", "name": "Морской вокзал", "latitude": 43.581969, "longitude": 39.719848,
+             "road_distances": {"Ривьерский мост": 850, "Пустая": 1300}},
+            {"type": "Stop", "name": "Пустая", "latitude": 43.5, "longitude": 39.7},
+            {"type": "Stop", "name": "Без маршрутов", "latitude": 43.6, "longitude": 39.8}
+        ],
+        "render_settings": {
+            "width": 200, "height": 200, "padding": 30, "stop_radius": 5, "line_width": 14,
+            "bus_label_font_size": 20, "bus_label_offset": [7, 15],
+            "stop_label_font_size": 20, "stop_label_offset": [7, -3],
+            "underlayer_color": [255, 255, 255, 0.85], "underlayer_width": 3,
+            "color_palette": ["green", [255, 160, 0], "red"]
+        },
+        "stat_requests": [
+            {"id": 1, "type": "Map"},
+            {"id": 2, "type": "Stop", "name": "Морской вокзал"},
+            {"id": 3, "type": "Bus", "name": "114"},
+            {"id": 4, "type": "Bus", "name": "24"},
+            {"id": 5, "type": "Stop", "name": "Без маршрутов"},
+            {"id": 6, "type": "Stop", "name": "Нет такой"}
+        ]
+    })";
+
+    std::string Answer(TransportCatalogue& catalogue, JsonReader& reader) {
+        renderer::MapRenderer renderer;
+        reader.ProcessRenderSettings(renderer);
+        RequestHandler handler(catalogue, renderer);
+        std::ostringstream out;
+        json::Writer writer(out);
+        reader.ProcessStatRequests(handler, writer);
+        writer.Flush();
+        return out.str();
+    }
+
+} // namespace
+
+TEST(Snapshot, RoundTripGivesSameAnswers) {
+    TransportCatalogue built;
+    JsonReader reader(std::string_view(kInput), built);
+    reader.ProcessBaseRequests();
+    const std::string data = snapshot::Save(built, reader.GetRenderSettings());
+    const std::string expected = Answer(built, reader);
+
+    TransportCatalogue loaded;
+    const json::Node settings = snapshot::Load(data, loaded);
+    EXPECT_EQ(settings, reader.GetRenderSettings());
+
+    JsonReader stats_only(std::string_view(kInput), loaded);
+    EXPECT_EQ(Answer(loaded, stats_only), expected);
+
+    ASSERT_EQ(loaded.GetStopCount(), built.GetStopCount());
+    for (const Stop& stop : built.GetAllStops()) {
+        const Stop* copy = loaded.FindStop(stop.name);
+        ASSERT_NE(copy, nullptr);
+        EXPECT_EQ(copy->id, stop.id);
+        EXPECT_EQ(copy->coordinates, stop.coordinates);
+        for (const Stop& other : built.GetAllStops()) {
+            EXPECT_EQ(loaded.GetDistance(copy->id, other.id), built.GetDistance(stop.id, other.id));
+        }
+    }
+    EXPECT_EQ(loaded.FindBus("24")->stops.size(), 3u);
+    EXPECT_EQ(loaded.FindStop("Нет такой"), nullptr);
+
+    // The loaded catalogue is still mutable
+    loaded.AddStop("Новая", {43.7, 39.9});
+    EXPECT_EQ(loaded.FindStop("Новая")->id, 4u);
+    EXPECT_EQ(loaded.FindStop("Пустая")->id, 2u);
+}
+
+TEST(Snapshot, KeepsRouteIndex) {
+    TransportCatalogue built;
+    JsonReader reader(std::string_view(kInput), built);
+    reader.ProcessBaseRequests();
+    router::TransportRouter transport_router(built, {6.0, 40.0});
+
+    std::optional<snapshot::RouteIndex> route_index;
+    {
+        TransportCatalogue loaded;
+        snapshot::Load(snapshot::Save(built, reader.GetRenderSettings()), loaded, &route_index);
+        EXPECT_FALSE(route_index);
+    }
+    {
+        TransportCatalogue loaded;
+        snapshot::Load(snapshot::Save(built, reader.GetRenderSettings(), &transport_router), loaded, &route_index);
+        ASSERT_TRUE(route_index);
+        EXPECT_EQ(route_index->settings, transport_router.GetSettings());
+        EXPECT_FALSE(route_index->landmarks);
+    }
+
+    transport_router.BuildIndex();
+    const std::string data = snapshot::Save(built, reader.GetRenderSettings(), &transport_router);
+    TransportCatalogue loaded;
+    snapshot::Load(data, loaded, &route_index);
+    ASSERT_TRUE(route_index && route_index->landmarks);
+    router::TransportRouter loaded_router(loaded, route_index->settings);
+    loaded_router.SetIndex(std::move(*route_index->landmarks));
+
+    const auto expected = transport_router.BuildRoute(built.FindStop("Пустая"), built.FindStop("Ривьерский мост"));
+    const auto route = loaded_router.BuildRoute(loaded.FindStop("Пустая"), loaded.FindStop("Ривьерский мост"));
+    ASSERT_TRUE(expected && route);
+    EXPECT_EQ(route->total_time, expected->total_time);
+    EXPECT_EQ(route->items.size(), expected->items.size());
+
+    // Loading without asking for the route index skips it
+    TransportCatalogue catalogue_only;
+    EXPECT_NO_THROW(snapshot::Load(data, catalogue_only));
+}
+
+TEST(Snapshot, RouteIndexOfExtendedCatalogueIsNotUsed) {
+    TransportCatalogue built;
+    JsonReader reader(std::string_view(kInput), built);
+    reader.ProcessBaseRequests();
+    router::TransportRouter transport_router(built, {6.0, 40.0});
+    transport_router.BuildIndex();
+    const std::string data = snapshot::Save(built, reader.GetRenderSettings(), &transport_router);
+
+    // Base requests after loading add a stop and a bus to the saved catalogue
+    TransportCatalogue loaded;
+    std::optional<snapshot::RouteIndex> route_index;
+    snapshot::Load(data, loaded, &route_index);
+    ASSERT_TRUE(route_index && route_index->landmarks);
+    const std::string extra = R"({"base_requests": [
+        {"type": "Stop", "name": "Новая", "latitude": 43.59, "longitude": 39.72,
+         "road_distances": {"Пустая": 2000}},
+        {"type": "Bus", "name": "7", "stops": ["Пустая", "Новая"], "is_roundtrip": false}
+    ]})";
+    JsonReader extra_reader(std::string_view(extra), loaded);
+    extra_reader.ProcessBaseRequests();
+
+    router::TransportRouter loaded_router(loaded, route_index->settings);
+    EXPECT_THROW(loaded_router.SetIndex(*route_index->landmarks), std::invalid_argument);
+    EXPECT_FALSE(loaded_router.TrySetIndex(std::move(*route_index->landmarks)));
+    EXPECT_EQ(loaded_router.GetIndex(), nullptr);
+
+    // Plain Dijkstra still answers, and so does a freshly built index
+    const auto route = loaded_router.BuildRoute(loaded.FindStop("Новая"), loaded.FindStop("Ривьерский мост"));
+    ASSERT_TRUE(route);
+    loaded_router.BuildIndex();
+    const auto indexed = loaded_router.BuildRoute(loaded.FindStop("Новая"), loaded.FindStop("Ривьерский мост"));
+    ASSERT_TRUE(indexed);
+    EXPECT_DOUBLE_EQ(indexed->total_time, route->total_time);
+
+    EXPECT_TRUE(loaded_router.TrySetIndex(*loaded_router.GetIndex()));
+}
+
+TEST(Snapshot, RejectsBrokenData) {
+    TransportCatalogue built;
+    JsonReader reader(std::string_view(kInput), built);
+    reader.ProcessBaseRequests();
+    const std::string data = snapshot::Save(built, reader.GetRenderSettings());
+
+    {
+        TransportCatalogue db;
+        EXPECT_THROW(snapshot::Load(std::string_view(data).substr(0, 16), db), snapshot::SnapshotError);
+    }
+    {
+        TransportCatalogue db;
+        EXPECT_THROW(snapshot::Load(std::string_view(data).substr(0, data.size() - 8), db), snapshot::SnapshotError);
+    }
+    {
+        std::string wrong_magic = data;
+        wrong_magic[0] = 'X';
+        TransportCatalogue db;
+        EXPECT_THROW(snapshot::Load(wrong_magic, db), snapshot::SnapshotError);
+    }
+    {
+        // The two distances from "Морской вокзал" are stored as {to, reserved, 850} and {to, reserved, 1300};
+        // swapping their targets breaks the row order
+        std::string unordered = data;
+        const double second_distance = 1300;
+        const size_t second = unordered.find(std::string_view(reinterpret_cast<const char*>(&second_distance),
+                                                              sizeof(second_distance)));
+        ASSERT_NE(second, std::string::npos);
+        const size_t record_size = 2 * sizeof(uint32_t) + sizeof(double);
+        std::swap_ranges(unordered.begin() + (second - 8 - record_size), unordered.begin() + (second - 4 - record_size),
+                         unordered.begin() + (second - 8));
+        TransportCatalogue db;
+        EXPECT_THROW(snapshot::Load(unordered, db), snapshot::SnapshotError);
+    }
+    {
+        TransportCatalogue db;
+        db.AddStop("A", {0, 0});
+        db.Freeze();
+        EXPECT_THROW(snapshot::Load(data, db), std::logic_error);
+        db.AddStop("B", {0, 0});
+        EXPECT_THROW(snapshot::Save(db, json::Node{}), std::logic_error);
+    }
+}
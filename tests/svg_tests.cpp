@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "svg.h"
+
+using namespace transport_catalogue;
+
+namespace {
+
+    std::string RenderToString(const svg::Document& doc) {
+        std::ostringstream out;
+        doc.Render(out);
+        return out.str();
+    }
+
+} // namespace
+
+TEST(Svg, RendersDocument) {
+    svg::Document doc;
+    doc.Add(svg::Circle().SetCenter({20, 20.5}).SetRadius(5).SetFillColor("white"));
+    doc.Add(svg::Polyline()
+                    .AddPoint({1.0 / 3.0, 100000})
+                    .AddPoint({1234567.0, 0.000012})
+                    .SetStrokeColor(svg::Rgba{255, 160, 0, 0.85})
+                    .SetStrokeWidth(14)
+                    .SetStrokeLineCap(svg::StrokeLineCap::ROUND)
+                    .SetStrokeLineJoin(svg::StrokeLineJoin::MITER_CLIP));
+    doc.Add(svg::Text()
+                    .SetPosition({1, 2})
+                    .SetOffset({7, -3})
+                    .SetFontSize(20)
+                    .SetFontFamily("Verdana")
+                    .SetData("<Tom & \"Jerry\"> 'x'")
+                    .SetFillColor(svg::Rgb{1, 2, 3}));
+
+    EXPECT_EQ(doc.GetObjectCount(), 3u);
+    // Numbers come out as std::ostream prints them by default
+    EXPECT_EQ(RenderToString(doc),
+              "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+              "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\">\n"
+              "<circle cx=\"20\" cy=\"20.5\" r=\"5\"  fill=\"white\"/>\n"
+              "<polyline points=\"0.333333,100000 1.23457e+06,1.2e-05\" stroke=\"rgba(255,160,0,0.85)\""
+              " stroke-linecap=\"round\" stroke-linejoin=\"miter-clip\" stroke-width=\"14\"/>\n"
+              "<text x=\"1\" y=\"2\" dx=\"7\" dy=\"-3\" font-size=\"20\" font-family=\"Verdana\""
+              " fill=\"rgb(1,2,3)\">&lt;Tom &amp; &quot;Jerry&quot;&gt; &apos;x&apos;</text>\n"
+              "</svg>");
+}
+
+TEST(Svg, WriterFlushesLargeOutput) {
+    svg::Document doc;
+    for (int i = 0; i < 10000; ++i) {
+        doc.Add(svg::Circle().SetCenter({static_cast<double>(i), 0}));
+    }
+    const std::string text = RenderToString(doc);
+    EXPECT_GT(text.size(), 64u * 1024u);
+    EXPECT_NE(text.find("<circle cx=\"9999\" cy=\"0\" r=\"1\" />"), std::string::npos);
+    EXPECT_TRUE(text.ends_with("</svg>"));
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "thread_pool.h"
+
+using namespace transport_catalogue;
+
+TEST(ThreadPool, RunsEveryIndexOnce) {
+    for (const size_t threads : {1u, 2u, 8u}) {
+        ThreadPool pool(threads);
+        EXPECT_EQ(pool.GetThreadCount(), threads);
+        for (const size_t count : {0u, 1u, 5u, 1000u}) {
+            std::vector<std::atomic<int>> calls(count);
+            pool.ParallelFor(count, [&calls](size_t i) { ++calls[i]; });
+            for (size_t i = 0; i < count; ++i) {
+                EXPECT_EQ(calls[i].load(), 1) << i;
+            }
+        }
+    }
+    EXPECT_GE(ThreadPool().GetThreadCount(), 1u);
+}
+
+TEST(ThreadPool, RethrowsAndStaysUsable) {
+    ThreadPool pool(4);
+    EXPECT_THROW(pool.ParallelFor(100, [](size_t i) {
+        if (i == 42) {
+            throw std::runtime_error("failed");
+        }
+    }), std::runtime_error);
+
+    std::atomic<size_t> sum = 0;
+    pool.ParallelFor(100, [&sum](size_t i) { sum += i; });
+    EXPECT_EQ(sum.load(), 4950u);
+}
+
+TEST(ThreadPool, RunsNestedLoopsInPlace) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> calls(20 * 30);
+    pool.ParallelFor(20, [&](size_t outer) {
+        pool.ParallelFor(30, [&](size_t inner) { ++calls[outer * 30 + inner]; });
+    });
+    for (const auto& count : calls) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
@@ -3,6 +3,14 @@
 
 #include "transport_catalogue.h"
 #include "geo.h"
+#include "perfect_hash.h"
+
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 using namespace transport_catalogue;
 
@@ -84,6 +92,209 @@ TEST(TransportCatalogue, FindBusAndStopReturnNullForMissing) {
     EXPECT_EQ(tc.FindBus("nope"), nullptr);
 }
 
+TEST(TransportCatalogue, DenseIdsAndRoutes) {
+    TransportCatalogue tc;
+    tc.AddStop("A", {55.0, 37.0});
+    tc.AddStop("B", {55.1, 37.1});
+    tc.AddStop("C", {55.2, 37.2});
+
+    const Stop* sa = tc.FindStop("A");
+    const Stop* sc = tc.FindStop("C");
+    EXPECT_EQ(sa->id, 0u);
+    EXPECT_EQ(sc->id, 2u);
+    EXPECT_EQ(&tc.GetStop(sc->id), sc);
+    ASSERT_EQ(tc.GetStopCount(), 3u);
+    EXPECT_EQ(tc.GetStopCoordinates()[1], (geo::Coordinates{55.1, 37.1}));
+
+    tc.AddBus("1", std::vector<const Stop*>{sc, sa, sc}, true);
+    tc.AddBus("2", std::vector<const Stop*>{sa}, false);
+    const Bus* bus = tc.FindBus("1");
+    ASSERT_NE(bus, nullptr);
+    EXPECT_EQ(&tc.GetBus(bus->id), bus);
+    EXPECT_EQ(tc.GetBusCount(), 2u);
+
+    const auto route = tc.GetRoute(bus->id);
+    EXPECT_EQ(std::vector<StopId>(route.begin(), route.end()), (std::vector<StopId>{2, 0, 2}));
+    EXPECT_EQ(tc.GetRoute(1).size(), 1u);
+
+    const auto info = tc.GetBusInfo("1");
+    ASSERT_TRUE(info);
+    EXPECT_EQ(info->stops_count, 3u);
+    EXPECT_EQ(info->unique_stops_count, 2u);
+}
+
+TEST(TransportCatalogue, FrozenDistancesKeepLookupRules) {
+    TransportCatalogue tc;
+    tc.AddStop("A", {55.0, 37.0});
+    tc.AddStop("B", {55.1, 37.1});
+    tc.AddStop("C", {55.2, 37.2});
+    const Stop* sa = tc.FindStop("A");
+    const Stop* sb = tc.FindStop("B");
+    const Stop* sc = tc.FindStop("C");
+
+    tc.SetDistance(sa, sc, 300.0);
+    tc.SetDistance(sa, sb, 100.0);
+    tc.SetDistance(sb, sa, 150.0);
+    tc.SetDistance(sa, sb, 120.0);
+    tc.Freeze();
+
+    EXPECT_DOUBLE_EQ(tc.GetDistance(sa, sb), 120.0);
+    EXPECT_DOUBLE_EQ(tc.GetDistance(sb, sa), 150.0);
+    EXPECT_DOUBLE_EQ(tc.GetDistance(sc, sa), 300.0);
+    EXPECT_DOUBLE_EQ(tc.GetDistance(sb, sc), 0.0);
+
+    // Changes after Freeze() are visible at once and survive the next Freeze()
+    tc.SetDistance(sc, sa, 50.0);
+    tc.SetDistance(sb, sc, 70.0);
+    EXPECT_DOUBLE_EQ(tc.GetDistance(sc, sa), 50.0);
+    EXPECT_DOUBLE_EQ(tc.GetDistance(sc, sb), 70.0);
+    tc.AddStop("D", {55.3, 37.3});
+    tc.Freeze();
+    EXPECT_DOUBLE_EQ(tc.GetDistance(sa, sc), 300.0);
+    EXPECT_DOUBLE_EQ(tc.GetDistance(sc, sa), 50.0);
+    EXPECT_DOUBLE_EQ(tc.GetDistance(sc, sb), 70.0);
+    EXPECT_DOUBLE_EQ(tc.GetDistance(sa, tc.FindStop("D")), 0.0);
+}
+
+TEST(TransportCatalogue, FrozenBusInfoFollowsChanges) {
+    TransportCatalogue tc;
+    tc.AddStop("A", {55.0, 37.0});
+    tc.AddStop("B", {55.1, 37.1});
+    const Stop* sa = tc.FindStop("A");
+    const Stop* sb = tc.FindStop("B");
+    tc.SetDistance(sa, sb, 1000.0);
+    tc.AddBus("1", std::vector<const Stop*>{sa, sb}, false);
+
+    const auto before = tc.GetBusInfo("1");
+    tc.Freeze();
+    const auto frozen = tc.GetBusInfo("1");
+    ASSERT_TRUE(before && frozen);
+    EXPECT_DOUBLE_EQ(frozen->route_length, 2000.0);
+    EXPECT_DOUBLE_EQ(frozen->curvature, before->curvature);
+    EXPECT_EQ(frozen->stops_count, 3u);
+
+    tc.SetDistance(sb, sa, 500.0);
+    EXPECT_DOUBLE_EQ(tc.GetBusInfo("1")->route_length, 1500.0);
+    tc.AddBus("2", std::vector<const Stop*>{sb, sa, sb}, true);
+    tc.Freeze();
+    EXPECT_DOUBLE_EQ(tc.GetBusInfo("1")->route_length, 1500.0);
+    EXPECT_DOUBLE_EQ(tc.GetBusInfo("2")->route_length, 1500.0);
+    EXPECT_FALSE(tc.GetBusInfo("3"));
+}
+
+TEST(TransportCatalogue, BusesForStopAreSortedByName) {
+    TransportCatalogue tc;
+    tc.AddStop("A", {0.0, 0.0});
+    tc.AddStop("B", {1.0, 1.0});
+    const Stop* sa = tc.FindStop("A");
+    const Stop* sb = tc.FindStop("B");
+
+    tc.AddBus("b", std::vector<const Stop*>{sa, sb, sa}, true);
+    tc.AddBus("c", std::vector<const Stop*>{sa}, false);
+    tc.AddBus("a", std::vector<const Stop*>{sb, sa}, false);
+
+    std::vector<std::string> names;
+    for (const Bus* bus : tc.GetBusesForStop(sa)) {
+        names.push_back(bus->name);
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_EQ(tc.GetBusesForStop(sb).size(), 2u);
+}
+
+TEST(TransportCatalogue, FrozenNameLookup) {
+    TransportCatalogue tc;
+    for (int i = 0; i < 1000; ++i) {
+        tc.AddStop("Stop " + std::to_string(i), {55.0, 37.0});
+    }
+    tc.AddBus("1", std::vector<const Stop*>{tc.FindStop("Stop 1")}, true);
+    tc.Freeze();
+
+    for (int i = 0; i < 1000; ++i) {
+        const Stop* stop = tc.FindStop("Stop " + std::to_string(i));
+        ASSERT_NE(stop, nullptr);
+        EXPECT_EQ(stop->id, static_cast<StopId>(i));
+        EXPECT_EQ(tc.FindStop("Stop " + std::to_string(i + 1000)), nullptr);
+    }
+    EXPECT_EQ(tc.FindStop(""), nullptr);
+    EXPECT_EQ(tc.FindBus("1")->name, "1");
+    EXPECT_EQ(tc.FindBus("2"), nullptr);
+
+    // Adding after Freeze() switches back to the mutable indexes
+    tc.AddBus("2", std::vector<const Stop*>{tc.FindStop("Stop 2")}, true);
+    EXPECT_EQ(tc.FindBus("2")->name, "2");
+    EXPECT_EQ(tc.FindStop("Stop 999")->id, 999u);
+    tc.Freeze();
+    EXPECT_EQ(tc.FindBus("2")->name, "2");
+    EXPECT_EQ(tc.FindBus("1")->name, "1");
+}
+
+TEST(PerfectHashIndex, MapsEveryKeyToItsId) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 5000; ++i) {
+        names.push_back(std::to_string(i * 7919));
+    }
+    std::vector<std::pair<std::string_view, uint32_t>> items;
+    for (uint32_t i = 0; i < names.size(); ++i) {
+        items.emplace_back(names[i], i);
+    }
+    const PerfectHashIndex index(items);
+    ASSERT_EQ(index.Size(), names.size());
+    for (uint32_t i = 0; i < names.size(); ++i) {
+        EXPECT_EQ(index.Find(names[i]), i);
+    }
+    EXPECT_TRUE(PerfectHashIndex{}.Empty());
+    EXPECT_EQ(PerfectHashIndex{}.Find("x"), INVALID_ID);
+    EXPECT_THROW(PerfectHashIndex({{"a", 0}, {"a", 1}}), std::logic_error);
+}
+
+TEST(TransportCatalogue, NearbyStopsMatchLinearScan) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> lat(-90.0, 90.0);
+    std::uniform_real_distribution<double> lng(-180.0, 180.0);
+    std::uniform_real_distribution<double> offset(-0.05, 0.05);
+
+    TransportCatalogue frozen;
+    TransportCatalogue scanned;
+    std::vector<geo::Coordinates> centers;
+    for (int i = 0; i < 2000; ++i) {
+        // Clusters around random points, the antimeridian and the north pole
+        const geo::Coordinates base = i % 10 == 0 ? geo::Coordinates{lat(rng), 179.99}
+                                    : i % 10 == 1 ? geo::Coordinates{89.99, lng(rng)}
+                                                  : geo::Coordinates{lat(rng), lng(rng)};
+        const geo::Coordinates point{std::clamp(base.lat + offset(rng), -90.0, 90.0), base.lng + offset(rng)};
+        frozen.AddStop(std::to_string(i), point);
+        scanned.AddStop(std::to_string(i), point);
+        if (i % 40 == 0) {
+            centers.push_back(base);
+        }
+    }
+    frozen.Freeze();
+
+    const double no_radius = std::numeric_limits<double>::infinity();
+    const size_t no_limit = std::numeric_limits<size_t>::max();
+    for (const auto& center : centers) {
+        for (const auto& [radius, limit] : {std::pair{5000.0, no_limit}, std::pair{no_radius, size_t{7}},
+                                            std::pair{20000.0, size_t{3}}, std::pair{0.0, no_limit}}) {
+            const auto expected = scanned.FindNearbyStops(center, radius, limit);
+            const auto found = frozen.FindNearbyStops(center, radius, limit);
+            ASSERT_EQ(found.size(), expected.size());
+            for (size_t i = 0; i < found.size(); ++i) {
+                EXPECT_EQ(found[i].stop->name, expected[i].stop->name);
+                EXPECT_EQ(found[i].distance, expected[i].distance);
+                EXPECT_LE(found[i].distance, radius);
+                EXPECT_NEAR(found[i].distance, geo::ComputeDistance(center, found[i].stop->coordinates), 1.0);
+            }
+        }
+    }
+    EXPECT_EQ(frozen.FindNearbyStops(centers[0], no_radius, no_limit).size(), 2000u);
+
+    // Adding a stop drops the index until the next Freeze(), answers stay correct
+    frozen.AddStop("new", centers[0]);
+    EXPECT_EQ(frozen.FindNearbyStops(centers[0], 0.0, 1).front().stop->name, "new");
+    frozen.Freeze();
+    EXPECT_EQ(frozen.FindNearbyStops(centers[0], 0.0, 1).front().stop->name, "new");
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
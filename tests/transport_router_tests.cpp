@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <variant>
+#include <vector>
+
+#include "landmarks.h"
+#include "router.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+using namespace transport_catalogue;
+using namespace transport_catalogue::router;
+
+namespace {
+
+    // A - B - C on bus "1" (there and back), C - D - C on roundtrip bus "2", E is not served
+    struct Network {
+        Network() {
+            db.AddStop("A", {55.60, 37.60});
+            db.AddStop("B", {55.61, 37.60});
+            db.AddStop("C", {55.62, 37.60});
+            db.AddStop("D", {55.62, 37.61});
+            db.AddStop("E", {55.70, 37.70});
+            db.SetDistance(db.FindStop("A"), db.FindStop("B"), 1000);
+            db.SetDistance(db.FindStop("B"), db.FindStop("C"), 2000);
+            db.SetDistance(db.FindStop("C"), db.FindStop("B"), 1500);
+            db.SetDistance(db.FindStop("C"), db.FindStop("D"), 600);
+            db.AddBus("1", {db.FindStop("A"), db.FindStop("B"), db.FindStop("C")}, false);
+            db.AddBus("2", {db.FindStop("C"), db.FindStop("D"), db.FindStop("C")}, true);
+            db.Freeze();
+        }
+
+        TransportCatalogue db;
+    };
+
+    void ExpectWait(const RouteItem& item, const char* stop, double time) {
+        const auto* wait = std::get_if<WaitItem>(&item);
+        ASSERT_NE(wait, nullptr);
+        EXPECT_EQ(wait->stop->name, stop);
+        EXPECT_DOUBLE_EQ(wait->time, time);
+    }
+
+    void ExpectBus(const RouteItem& item, const char* bus, int span_count, double time) {
+        const auto* ride = std::get_if<BusItem>(&item);
+        ASSERT_NE(ride, nullptr);
+        EXPECT_EQ(ride->bus->name, bus);
+        EXPECT_EQ(ride->span_count, span_count);
+        EXPECT_DOUBLE_EQ(ride->time, time);
+    }
+
+} // namespace
+
+TEST(TransportRouter, BuildsItemizedRoutes) {
+    const Network net;
+    // 60 km/h is 1000 meters per minute
+    const TransportRouter router(net.db, {5.0, 60.0});
+    const auto stop = [&net](const char* name) { return net.db.FindStop(name); };
+
+    const auto forward = router.BuildRoute(stop("A"), stop("C"));
+    ASSERT_TRUE(forward);
+    EXPECT_DOUBLE_EQ(forward->total_time, 8.0);
+    ASSERT_EQ(forward->items.size(), 2u);
+    ExpectWait(forward->items[0], "A", 5.0);
+    ExpectBus(forward->items[1], "1", 2, 3.0);
+
+    // The way back uses C -> B as set and A -> B for B -> A
+    const auto back = router.BuildRoute(stop("C"), stop("A"));
+    ASSERT_TRUE(back);
+    EXPECT_DOUBLE_EQ(back->total_time, 7.5);
+    ExpectBus(back->items[1], "1", 2, 2.5);
+
+    const auto transfer = router.BuildRoute(stop("A"), stop("D"));
+    ASSERT_TRUE(transfer);
+    EXPECT_DOUBLE_EQ(transfer->total_time, 13.6);
+    ASSERT_EQ(transfer->items.size(), 4u);
+    ExpectWait(transfer->items[2], "C", 5.0);
+    ExpectBus(transfer->items[3], "2", 1, 0.6);
+
+    const auto same = router.BuildRoute(stop("B"), stop("B"));
+    ASSERT_TRUE(same);
+    EXPECT_EQ(same->total_time, 0.0);
+    EXPECT_TRUE(same->items.empty());
+
+    EXPECT_FALSE(router.BuildRoute(stop("A"), stop("E")));
+    EXPECT_FALSE(router.BuildRoute(stop("A"), nullptr));
+}
+
+TEST(TransportRouter, RejectsBadSettings) {
+    const Network net;
+    EXPECT_THROW(TransportRouter(net.db, {5.0, 0.0}), std::invalid_argument);
+    EXPECT_THROW(TransportRouter(net.db, {-1.0, 40.0}), std::invalid_argument);
+}
+
+TEST(TransportRouter, UsesLandmarkIndex) {
+    const Network net;
+    TransportRouter router(net.db, {5.0, 60.0});
+    EXPECT_EQ(router.GetIndex(), nullptr);
+    router.BuildIndex();
+    ASSERT_NE(router.GetIndex(), nullptr);
+    const auto stop = [&net](const char* name) { return net.db.FindStop(name); };
+
+    const auto transfer = router.BuildRoute(stop("A"), stop("D"));
+    ASSERT_TRUE(transfer);
+    EXPECT_DOUBLE_EQ(transfer->total_time, 13.6);
+    ASSERT_EQ(transfer->items.size(), 4u);
+    ExpectWait(transfer->items[0], "A", 5.0);
+    ExpectBus(transfer->items[1], "1", 2, 3.0);
+    ExpectWait(transfer->items[2], "C", 5.0);
+    ExpectBus(transfer->items[3], "2", 1, 0.6);
+
+    const auto back = router.BuildRoute(stop("C"), stop("A"));
+    ASSERT_TRUE(back);
+    EXPECT_DOUBLE_EQ(back->total_time, 7.5);
+    EXPECT_FALSE(router.BuildRoute(stop("A"), stop("E")));
+
+    // An index of a graph with other weights does not fit
+    TransportRouter slower(net.db, {5.0, 30.0});
+    EXPECT_THROW(slower.SetIndex(*router.GetIndex()), std::invalid_argument);
+    EXPECT_NO_THROW(slower.SetIndex(graph::Landmarks(slower.GetGraph())));
+}
+
+TEST(Landmarks, MatchesDijkstraOnRandomGraphs) {
+    std::mt19937 rng(42);
+    for (const uint32_t vertex_count : {1u, 2u, 30u, 200u}) {
+        std::uniform_int_distribution<uint32_t> vertex(0, vertex_count - 1);
+        std::uniform_real_distribution<double> weight(0.0, 20.0);
+        std::vector<graph::Edge<double>> edges;
+        for (uint32_t i = 0; i < vertex_count * 2; ++i) {
+            edges.push_back({vertex(rng), vertex(rng), weight(rng)});
+        }
+        const graph::DirectedWeightedGraph<double> g(vertex_count, std::move(edges));
+        const graph::Router<double> dijkstra(g);
+        const graph::Landmarks index(g, 4);
+        EXPECT_TRUE(index.Matches(g));
+
+        for (int query = 0; query < 200; ++query) {
+            const graph::VertexId from = vertex(rng);
+            const graph::VertexId to = vertex(rng);
+            const auto expected = dijkstra.BuildRoute(from, to);
+            const auto route = index.BuildRoute(g, from, to);
+            ASSERT_EQ(route.has_value(), expected.has_value()) << from << " -> " << to;
+            if (!route) {
+                continue;
+            }
+            EXPECT_DOUBLE_EQ(route->weight, expected->weight);
+            // The edges form a path of that length
+            double length = 0.0;
+            graph::VertexId at = from;
+            for (const graph::EdgeId id : route->edges) {
+                ASSERT_EQ(g.GetEdge(id).from, at);
+                at = g.GetEdge(id).to;
+                length += g.GetEdge(id).weight;
+            }
+            EXPECT_EQ(at, to);
+            EXPECT_DOUBLE_EQ(length, route->weight);
+        }
+
+        // Restoring from the saved parts gives the same index
+        const graph::Landmarks restored(index.GetLandmarks(), index.GetDistances(), index.GetGraphHash());
+        EXPECT_TRUE(restored.Matches(g));
+        EXPECT_EQ(restored.BuildRoute(g, 0, vertex_count - 1).has_value(),
+                  dijkstra.BuildRoute(0, vertex_count - 1).has_value());
+    }
+
+    EXPECT_THROW(graph::Landmarks({0}, {0.0f, 1.0f, 2.0f}, 0), std::invalid_argument);
+    EXPECT_THROW(graph::Landmarks({1}, {0.0f, 0.0f}, 0), std::invalid_argument);
+    EXPECT_THROW(graph::Landmarks({0}, {1.0f, 0.0f}, 0), std::invalid_argument);
+    EXPECT_THROW(graph::Landmarks({0}, {0.0f, 0.0f, -1.0f, 0.0f}, 0), std::invalid_argument);
+}